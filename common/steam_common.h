@@ -0,0 +1,810 @@
+// Code shared by Sequential.cpp and parallel.cpp: the raw and structured row types, the
+// string pool, the compact numeric columns, the top-k ranking types, the group-by
+// aggregation engine, the hardware performance counters and the repeated-run statistics.
+//
+// Each program includes this header once, at the top, and keeps its own loaders and
+// drivers: the single-pass and the radix-partitioned run_report(), the two select_top()
+// variants, benchmark() and so on. The parsing kernels are in steam_kernels.h. A fix to
+// anything below is made here once.
+#ifndef STEAM_COMMON_H
+#define STEAM_COMMON_H
+
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <string>
+#include <map>
+#include <sstream>
+#include <algorithm>
+#include <unordered_map>
+#include <deque>
+#include <string_view>
+#include <cstdint>
+#include <cmath>
+#include <array>
+#include <tuple>
+#include <utility>
+#include <limits>
+#include <cctype>
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+#include <sqlite3.h>
+
+// ===================== Command-Line Values =====================
+
+// Parse "0-3,6" into {0, 1, 2, 3, 6}; returns an empty list on bad input
+inline std::vector<int> parse_int_list(const std::string& text) {
+    std::vector<int> values;
+    std::stringstream ss(text);
+    std::string part;
+    while (std::getline(ss, part, ',')) {
+        try {
+            size_t dash = part.find('-');
+            int lo = std::stoi(part.substr(0, dash));
+            int hi = dash == std::string::npos ? lo : std::stoi(part.substr(dash + 1));
+            if (lo < 0 || hi < lo) return {};
+            for (int v = lo; v <= hi; ++v) values.push_back(v);
+        } catch (...) {
+            return {};
+        }
+    }
+    return values;
+}
+
+// Parse "1000,100k,2M" into row counts; returns an empty list on bad input
+inline std::vector<int> parse_size_list(const std::string& text) {
+    std::vector<int> sizes;
+    std::stringstream ss(text);
+    std::string part;
+    while (std::getline(ss, part, ',')) {
+        try {
+            size_t used = 0;
+            long long value = std::stoll(part, &used);
+            std::string suffix = part.substr(used);
+            if (suffix == "k" || suffix == "K") value *= 1000;
+            else if (suffix == "m" || suffix == "M") value *= 1000000;
+            else if (!suffix.empty()) return {};
+            if (value <= 0 || value > INT32_MAX) return {};
+            sizes.push_back(static_cast<int>(value));
+        } catch (...) {
+            return {};
+        }
+    }
+    return sizes;
+}
+
+// Parse a whole non-negative decimal number that fits in T; false on bad input, trailing
+// characters or overflow, so a bad flag value can be reported instead of throwing
+template <class T>
+bool parse_count(const std::string& text, T& out) {
+    if (text.empty() || !std::isdigit(static_cast<unsigned char>(text[0]))) return false;
+    try {
+        size_t used = 0;
+        unsigned long long value = std::stoull(text, &used);
+        if (used != text.size() || value > static_cast<unsigned long long>(std::numeric_limits<T>::max())) return false;
+        out = static_cast<T>(value);
+        return true;
+    } catch (...) {
+        return false;
+    }
+}
+
+// ===================== Raw Rows =====================
+
+// Struct to hold raw database rows
+struct RawSteamRow {
+    std::string url;
+    std::string types;
+    std::string name;
+    std::string desc_snippet;
+    std::string recent_reviews;
+    std::string all_reviews;
+    std::string release_date;
+    std::string developer;
+    std::string publisher;
+    std::string popular_tags;
+    std::string game_details;
+    std::string languages;
+    std::string achievements;
+    std::string genre;
+    std::string game_description;
+    std::string mature_content;
+    std::string minimum_requirements;
+    std::string recommended_requirements;
+    std::string original_price;
+    std::string discount_price;
+};
+
+// Safe string reader to prevent null crashes
+inline std::string get_text(sqlite3_stmt* stmt, int col) {
+    const unsigned char* val = sqlite3_column_text(stmt, col);
+    return val ? reinterpret_cast<const char*>(val) : "";
+}
+
+// Read the current result row of a 'SELECT * FROM steam_games' statement
+inline RawSteamRow read_raw_row(sqlite3_stmt* stmt) {
+    RawSteamRow row;
+    row.url                      = get_text(stmt, 0);
+    row.types                    = get_text(stmt, 1);
+    row.name                     = get_text(stmt, 2);
+    row.desc_snippet             = get_text(stmt, 3);
+    row.recent_reviews           = get_text(stmt, 4);
+    row.all_reviews              = get_text(stmt, 5);
+    row.release_date             = get_text(stmt, 6);
+    row.developer                = get_text(stmt, 7);
+    row.publisher                = get_text(stmt, 8);
+    row.popular_tags             = get_text(stmt, 9);
+    row.game_details             = get_text(stmt, 10);
+    row.languages                = get_text(stmt, 11);
+    row.achievements             = get_text(stmt, 12);
+    row.genre                    = get_text(stmt, 13);
+    row.game_description         = get_text(stmt, 14);
+    row.mature_content           = get_text(stmt, 15);
+    row.minimum_requirements     = get_text(stmt, 16);
+    row.recommended_requirements = get_text(stmt, 17);
+    row.original_price           = get_text(stmt, 18);
+    row.discount_price           = get_text(stmt, 19);
+    return row;
+}
+
+// ===================== String Pool & Structured Games =====================
+
+// Hash-consing pool for values many games share (developer, publisher, languages, tags).
+// Each distinct value is stored once; games hold a 32-bit handle into the pool.
+struct StringPool {
+    std::deque<std::string> values;                        // id -> value (deque keeps addresses stable)
+    std::unordered_map<std::string_view, uint32_t> index;  // value -> id
+    size_t requests = 0;          // intern() calls
+    size_t requested_bytes = 0;   // bytes that would have been stored without pooling
+    size_t stored_bytes = 0;      // bytes actually stored
+
+    StringPool() { clear(); }
+    StringPool(const StringPool&) = delete;
+    StringPool& operator=(const StringPool&) = delete;
+    StringPool(StringPool&&) = default;
+
+    void clear() {
+        values.clear();
+        index.clear();
+        requests = requested_bytes = stored_bytes = 0;
+        values.emplace_back();  // id 0 is always the empty string
+        index.emplace(values.back(), 0);
+    }
+
+    // Same as intern() without counting toward the pooling stats
+    uint32_t insert(const std::string& s) {
+        auto it = index.find(s);
+        if (it != index.end()) return it->second;
+        uint32_t id = static_cast<uint32_t>(values.size());
+        values.push_back(s);
+        index.emplace(values.back(), id);
+        stored_bytes += s.size();
+        return id;
+    }
+
+    uint32_t intern(const std::string& s) {
+        requests++;
+        requested_bytes += s.size();
+        return insert(s);
+    }
+
+    // Fold a thread-local pool into this one; returns local id -> global id
+    std::vector<uint32_t> merge_from(const StringPool& local) {
+        std::vector<uint32_t> remap(local.values.size());
+        for (size_t i = 0; i < local.values.size(); ++i)
+            remap[i] = insert(local.values[i]);
+        requests += local.requests;
+        requested_bytes += local.requested_bytes;
+        return remap;
+    }
+
+    const std::string& get(uint32_t id) const { return values[id]; }
+    size_t size() const { return values.size(); }
+};
+
+inline StringPool string_pool;
+
+// Handle to a pooled string; only valid against string_pool once formatting has finished
+struct PooledStr {
+    uint32_t id = 0;
+    bool empty() const { return id == 0; }
+    const std::string& str() const { return string_pool.get(id); }
+};
+
+struct SteamGame {
+    std::string url;
+    std::string types;
+    std::string name;
+    std::string desc_snippet;
+    std::string recent_reviews;
+    std::string all_reviews;
+    std::string release_date;
+    PooledStr developer;
+    PooledStr publisher;
+    PooledStr popular_tags;
+    std::string game_details;
+    PooledStr languages;
+    std::string achievements;
+    std::string genre;
+    std::string game_description;
+    std::string mature_content;
+    std::string minimum_requirements;
+    std::string recommended_requirements;
+    float original_price = -1.0f;
+    float discount_price = -1.0f;
+    float all_reviews_percent = -1.0f;
+    float recent_reviews_percent = -1.0f;
+    std::string overall_genre;
+    std::vector<uint32_t> genre_ids;   // overall_genre tokens as ids into genre_dict
+};
+
+inline std::vector<SteamGame> structured_games;
+
+// Dense ids for individual genre and language tokens, rebuilt by every format_all_games()
+inline StringPool genre_dict;
+inline StringPool language_dict;
+inline std::vector<std::vector<uint32_t>> language_tokens;   // string_pool id -> language_dict ids
+
+// ===================== Compact Numeric Columns =====================
+
+// Optional column store for the numeric fields: prices as cents, percentages as whole
+// percent, and a validity bitmap instead of the -1.0f sentinel. Enabled with --compact.
+// A percentage outside 0-100 is not a review score and is stored as missing.
+inline bool use_compact_columns = false;
+
+struct ValidityBitmap {
+    std::vector<uint64_t> words;
+
+    void reset(size_t n) { words.assign((n + 63) / 64, 0); }
+    void set(size_t i) { words[i >> 6] |= uint64_t(1) << (i & 63); }
+    bool test(size_t i) const { return (words[i >> 6] >> (i & 63)) & 1; }
+};
+
+struct CompactColumns {
+    std::vector<uint32_t> original_price_cents;
+    std::vector<uint32_t> discount_price_cents;
+    std::vector<uint8_t> all_reviews_pct;
+    std::vector<uint8_t> recent_reviews_pct;
+    ValidityBitmap original_price_valid, discount_price_valid;
+    ValidityBitmap all_reviews_valid, recent_reviews_valid;
+    size_t rows = 0;
+
+    size_t bytes() const {
+        return rows * (2 * sizeof(uint32_t) + 2 * sizeof(uint8_t)) + 4 * original_price_valid.words.size() * sizeof(uint64_t);
+    }
+
+    // Size every column for 'total' rows, all missing
+    void reset(size_t total) {
+        rows = total;
+        original_price_cents.assign(total, 0);
+        discount_price_cents.assign(total, 0);
+        all_reviews_pct.assign(total, 0);
+        recent_reviews_pct.assign(total, 0);
+        original_price_valid.reset(total);
+        discount_price_valid.reset(total);
+        all_reviews_valid.reset(total);
+        recent_reviews_valid.reset(total);
+    }
+};
+
+inline CompactColumns compact_columns;
+
+inline uint32_t to_cents(float price) { return static_cast<uint32_t>(std::lround(price * 100.0f)); }
+inline uint8_t to_percent(float pct) { return static_cast<uint8_t>(std::lround(pct)); }
+inline bool is_percent(float pct) { return pct >= 0 && pct <= 100; }
+
+// Fill rows [start, end) from structured_games. A range that starts on a 64-row boundary
+// writes only its own bitmap words, so disjoint ranges can be filled concurrently.
+inline void fill_compact_columns(size_t start, size_t end) {
+    auto& c = compact_columns;
+    for (size_t i = start; i < end; ++i) {
+        const auto& g = structured_games[i];
+        if (g.original_price >= 0)                { c.original_price_cents[i] = to_cents(g.original_price); c.original_price_valid.set(i); }
+        if (g.discount_price >= 0)                { c.discount_price_cents[i] = to_cents(g.discount_price); c.discount_price_valid.set(i); }
+        if (is_percent(g.all_reviews_percent))    { c.all_reviews_pct[i] = to_percent(g.all_reviews_percent); c.all_reviews_valid.set(i); }
+        if (is_percent(g.recent_reviews_percent)) { c.recent_reviews_pct[i] = to_percent(g.recent_reviews_percent); c.recent_reviews_valid.set(i); }
+    }
+}
+
+// Numeric views the aggregation kernels are written against. The compact view
+// holds whole percents and cents; the float view reads SteamGame directly.
+struct FloatColumnsView {
+    static constexpr double price_scale = 1.0;
+    const std::vector<SteamGame>& games;
+
+    bool has_all(size_t i) const    { return games[i].all_reviews_percent >= 0; }
+    bool has_recent(size_t i) const { return games[i].recent_reviews_percent >= 0; }
+    bool has_price(size_t i) const  { return games[i].original_price >= 0; }
+    float all(size_t i) const       { return games[i].all_reviews_percent; }
+    float recent(size_t i) const    { return games[i].recent_reviews_percent; }
+    float price(size_t i) const     { return games[i].original_price; }
+    float rating(size_t i) const    { return games[i].all_reviews_percent; }  // -1 when missing
+};
+
+struct CompactColumnsView {
+    static constexpr double price_scale = 0.01;
+    const CompactColumns& c;
+
+    bool has_all(size_t i) const     { return c.all_reviews_valid.test(i); }
+    bool has_recent(size_t i) const  { return c.recent_reviews_valid.test(i); }
+    bool has_price(size_t i) const   { return c.original_price_valid.test(i); }
+    uint32_t all(size_t i) const     { return c.all_reviews_pct[i]; }
+    uint32_t recent(size_t i) const  { return c.recent_reviews_pct[i]; }
+    uint32_t price(size_t i) const   { return c.original_price_cents[i]; }
+    float rating(size_t i) const     { return has_all(i) ? c.all_reviews_pct[i] : -1.0f; }
+};
+
+// ===================== Top-K Ranking =====================
+
+struct TopGame {
+    std::string name;
+    std::string developer;
+    float rating;
+    float price;
+    std::string release_date;
+};
+
+inline std::vector<TopGame> top_games;
+inline std::vector<std::pair<std::string, int>> top_genres;
+
+// Top-K selection over the rating column. The default query (k = 1, keep ties)
+// returns every game tied at the highest rating; --top-k / --top-ties change it.
+enum class TiePolicy { Exact, KeepTies };
+
+struct TopKQuery {
+    size_t k = 1;
+    TiePolicy ties = TiePolicy::KeepTies;   // KeepTies also returns rows equal to the k-th
+};
+
+inline TopKQuery top_games_query;
+
+struct RankedRow {
+    float rating;
+    size_t row;
+};
+
+// Better-first order: higher rating, then earlier row
+inline bool ranks_before(const RankedRow& a, const RankedRow& b) {
+    return a.rating != b.rating ? a.rating > b.rating : a.row < b.row;
+}
+
+// ===================== Group-By Aggregation Engine =====================
+// A stats report is a key column plus a list of aggregate functors (avg, count, mode,
+// anti-mode). Each functor owns a small State with add / finish, and states merge with
+// merge_into(), so a report can run in one pass, per radix partition, per out-of-core
+// batch or per spilled run. A new "stats by X" report is one make_report() call; each
+// program supplies its own run_report() driver.
+
+// Numeric columns, read through a FloatColumnsView or CompactColumnsView.
+// get() is in view units; scale() turns a view-unit sum back into field units.
+
+// Mean of all/recent when both exist, else whichever is present; summed doubled
+struct CombinedRatingCol {
+    template <class View> static bool has(const View& v, size_t r) { return v.has_all(r) || v.has_recent(r); }
+    template <class View> static double get(const View& v, size_t r) {
+        if (v.has_all(r) && v.has_recent(r)) return double(v.all(r)) + v.recent(r);
+        return 2.0 * (v.has_all(r) ? v.all(r) : v.recent(r));
+    }
+    template <class View> static double scale(const View&) { return 0.5; }
+};
+
+struct PriceCol {
+    template <class View> static bool has(const View& v, size_t r)   { return v.has_price(r); }
+    template <class View> static double get(const View& v, size_t r) { return v.price(r); }
+    template <class View> static double scale(const View&)           { return View::price_scale; }
+};
+
+// Token columns: interned ids per row, names from the matching dictionary
+struct GenreTokens {
+    static const std::vector<uint32_t>& tokens(size_t r) { return structured_games[r].genre_ids; }
+    static const std::string& name(uint32_t id)          { return genre_dict.get(id); }
+};
+
+struct LanguageTokens {
+    static const std::vector<uint32_t>& tokens(size_t r) { return language_tokens[structured_games[r].languages.id]; }
+    static const std::string& name(uint32_t id)          { return language_dict.get(id); }
+};
+
+// Key columns: pooled ids, so grouping hashes integers instead of names
+struct DeveloperKey {
+    using Key = uint32_t;
+    static bool valid(size_t r)           { return !structured_games[r].developer.empty(); }
+    static Key key(size_t r)              { return structured_games[r].developer.id; }
+    static const std::string& name(Key k) { return string_pool.get(k); }
+};
+
+struct PublisherKey {
+    using Key = uint32_t;
+    static bool valid(size_t r)           { return !structured_games[r].publisher.empty(); }
+    static Key key(size_t r)              { return structured_games[r].publisher.id; }
+    static const std::string& name(Key k) { return string_pool.get(k); }
+};
+
+// Aggregate states. Sums are kept in double, which is exact for prices and percentages,
+// so partial states can be merged in any order.
+struct CountState { int n = 0; };
+struct SumState { double sum = 0; int n = 0; };
+
+// A flat vector beats a hash map for the handful of distinct tokens in most groups
+struct TokenFreq {
+    std::vector<std::pair<uint32_t, int>> counts;
+
+    void add(uint32_t id, int n) {
+        for (auto& c : counts)
+            if (c.first == id) { c.second += n; return; }
+        counts.emplace_back(id, n);
+    }
+};
+
+inline void merge_into(CountState& a, const CountState& b) { a.n += b.n; }
+inline void merge_into(SumState& a, const SumState& b) { a.sum += b.sum; a.n += b.n; }
+inline void merge_into(TokenFreq& a, const TokenFreq& b) { for (const auto& [id, n] : b.counts) a.add(id, n); }
+
+template <class... S, size_t... I>
+void merge_states(std::tuple<S...>& a, const std::tuple<S...>& b, std::index_sequence<I...>) {
+    (merge_into(std::get<I>(a), std::get<I>(b)), ...);
+}
+
+template <class... S>
+void merge_into(std::tuple<S...>& a, const std::tuple<S...>& b) { merge_states(a, b, std::index_sequence_for<S...>{}); }
+
+// Aggregate functors; each writes one field of the Stats row
+template <class Stats>
+struct Count {
+    using State = CountState;
+    int Stats::*out;
+
+    template <class View> void add(State& s, const View&, size_t) const { s.n++; }
+    template <class View> void finish(const State& s, const View&, Stats& row) const { row.*out = s.n; }
+};
+
+// Mean over the rows where the column is present
+template <class Stats, class Col>
+struct Avg {
+    using State = SumState;
+    float Stats::*out;
+
+    template <class View> void add(State& s, const View& v, size_t r) const {
+        if (Col::has(v, r)) { s.sum += Col::get(v, r); s.n++; }
+    }
+    template <class View> void finish(const State& s, const View& v, Stats& row) const {
+        row.*out = s.n ? static_cast<float>(s.sum * Col::scale(v) / s.n) : 0.0f;
+    }
+};
+
+// Most (or least) frequent token; ties go to the smaller name so results are stable
+template <class Stats, class Col, bool Most>
+struct TokenExtreme {
+    using State = TokenFreq;
+    std::string Stats::*out;
+
+    template <class View> void add(State& s, const View&, size_t r) const {
+        for (uint32_t id : Col::tokens(r)) s.add(id, 1);
+    }
+    template <class View> void finish(const State& s, const View&, Stats& row) const {
+        const std::pair<uint32_t, int>* best = nullptr;
+        for (const auto& c : s.counts) {
+            if (!best || (Most ? c.second > best->second : c.second < best->second) ||
+                (c.second == best->second && Col::name(c.first) < Col::name(best->first)))
+                best = &c;
+        }
+        row.*out = best ? Col::name(best->first) : "";
+    }
+};
+
+template <class Stats, class Col> using Mode = TokenExtreme<Stats, Col, true>;
+template <class Stats, class Col> using AntiMode = TokenExtreme<Stats, Col, false>;
+
+template <class Col, class Stats> Avg<Stats, Col> avg_of(float Stats::*out)                   { return {out}; }
+template <class Stats> Count<Stats> count_of(int Stats::*out)                                 { return {out}; }
+template <class Col, class Stats> Mode<Stats, Col> mode_of(std::string Stats::*out)           { return {out}; }
+template <class Col, class Stats> AntiMode<Stats, Col> anti_mode_of(std::string Stats::*out)  { return {out}; }
+
+template <class Stats, class KeyCol, class... Aggs>
+struct GroupByReport {
+    using Row = Stats;
+    using KeyColumn = KeyCol;
+    using States = std::tuple<typename Aggs::State...>;
+    using Table = std::unordered_map<typename KeyCol::Key, States>;
+
+    std::string Stats::*key_out;
+    std::tuple<Aggs...> aggs;
+
+    // Hash-aggregate rows [begin, end) into table
+    template <class View>
+    void aggregate(const View& v, size_t begin, size_t end, Table& table) const {
+        for (size_t r = begin; r < end; ++r)
+            if (KeyCol::valid(r)) add(table[KeyCol::key(r)], v, r);
+    }
+
+    template <class View>
+    void add(States& states, const View& v, size_t r) const {
+        add_row(states, v, r, std::index_sequence_for<Aggs...>{});
+    }
+
+    template <class View>
+    Stats finish(const std::string& key, const States& states, const View& v) const {
+        Stats row;
+        row.*key_out = key;
+        finish_row(states, v, row, std::index_sequence_for<Aggs...>{});
+        return row;
+    }
+
+    // One Stats row per group, ordered by key
+    template <class View>
+    std::vector<Stats> finish_all(const Table& table, const View& v) const {
+        std::vector<Stats> rows;
+        rows.reserve(table.size());
+        for (const auto& [key, states] : table)
+            rows.push_back(finish(KeyCol::name(key), states, v));
+        sort_rows(rows);
+        return rows;
+    }
+
+    void sort_rows(std::vector<Stats>& rows) const {
+        std::sort(rows.begin(), rows.end(), [&](const Stats& a, const Stats& b) { return a.*key_out < b.*key_out; });
+    }
+
+    template <class View, size_t... I>
+    void add_row(States& states, const View& v, size_t r, std::index_sequence<I...>) const {
+        (std::get<I>(aggs).add(std::get<I>(states), v, r), ...);
+    }
+
+    template <class View, size_t... I>
+    void finish_row(const States& states, const View& v, Stats& row, std::index_sequence<I...>) const {
+        (std::get<I>(aggs).finish(std::get<I>(states), v, row), ...);
+    }
+};
+
+template <class KeyCol, class Stats, class... Aggs>
+GroupByReport<Stats, KeyCol, Aggs...> make_report(std::string Stats::*key_out, Aggs... aggs) {
+    return {key_out, std::make_tuple(aggs...)};
+}
+
+// The developer and publisher reports share one aggregate list
+template <class KeyCol, class Stats>
+auto game_stats_report(std::string Stats::*key_out) {
+    return make_report<KeyCol>(key_out,
+        avg_of<CombinedRatingCol>(&Stats::avg_rating),
+        avg_of<PriceCol>(&Stats::avg_price),
+        mode_of<GenreTokens>(&Stats::most_common_genre),
+        anti_mode_of<GenreTokens>(&Stats::least_common_genre),
+        mode_of<LanguageTokens>(&Stats::most_common_language),
+        anti_mode_of<LanguageTokens>(&Stats::least_common_language));
+}
+
+struct DeveloperStats {
+    std::string developer;
+    float avg_rating = 0;
+    float avg_price = 0;
+    std::string most_common_genre;
+    std::string least_common_genre;
+    std::string most_common_language;
+    std::string least_common_language;
+};
+
+struct PublisherStats {
+    std::string publisher;
+    float avg_rating = 0;
+    float avg_price = 0;
+    std::string most_common_genre;
+    std::string least_common_genre;
+    std::string most_common_language;
+    std::string least_common_language;
+};
+
+inline std::vector<DeveloperStats> developer_stats;
+inline std::vector<PublisherStats> publisher_stats;
+inline const auto developer_report = game_stats_report<DeveloperKey>(&DeveloperStats::developer);
+inline const auto publisher_report = game_stats_report<PublisherKey>(&PublisherStats::publisher);
+
+// ===================== Hardware Performance Counters =====================
+// --perf-counters wraps every stage in a perf_event_open counter group: cycles,
+// instructions, cache misses, branch misses and page faults (user space only). Counters
+// are per thread; each thread opens its group on first use. Where perf events are
+// unavailable (other OSes, perf_event_paranoid, containers) the flag is ignored and
+// stages are timed only.
+
+enum PerfEvent { PERF_CYCLES, PERF_INSTRUCTIONS, PERF_CACHE_MISSES, PERF_BRANCH_MISSES, PERF_PAGE_FAULTS, PERF_EVENTS };
+
+struct PerfCounts {
+    std::array<uint64_t, PERF_EVENTS> value{};
+    unsigned int present = 0;   // bit e set when event e was counted
+    bool valid = false;
+
+    bool has(int e) const { return valid && (present >> e & 1); }
+
+    PerfCounts& operator+=(const PerfCounts& o) {
+        if (!o.valid) return *this;
+        for (int e = 0; e < PERF_EVENTS; ++e) value[e] += o.value[e];
+        present = valid ? present & o.present : o.present;
+        valid = true;
+        return *this;
+    }
+};
+
+inline PerfCounts operator-(const PerfCounts& after, const PerfCounts& before) {
+    PerfCounts d;
+    d.valid = after.valid && before.valid;
+    d.present = after.present & before.present;
+    for (int e = 0; e < PERF_EVENTS; ++e)
+        d.value[e] = after.value[e] > before.value[e] ? after.value[e] - before.value[e] : 0;
+    return d;
+}
+
+inline bool perf_counters_enabled = false;   // --perf-counters
+
+#ifdef __linux__
+// One thread's counter group. The first event that opens leads it; events the kernel
+// or CPU refuses are left out. One read() returns every member in opening order.
+struct PerfGroup {
+    int fds[PERF_EVENTS];
+    int slot[PERF_EVENTS];   // position of event e in the group read, -1 if missing
+    int members = 0;
+    bool opened = false;
+
+    PerfGroup() {
+        std::fill(std::begin(fds), std::end(fds), -1);
+        std::fill(std::begin(slot), std::end(slot), -1);
+    }
+
+    ~PerfGroup() {
+        for (int fd : fds)
+            if (fd >= 0) ::close(fd);
+    }
+
+    void open() {
+        opened = true;
+        const std::pair<uint32_t, uint64_t> events[PERF_EVENTS] = {
+            {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+            {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+            {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES},
+            {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+            {PERF_TYPE_SOFTWARE, PERF_COUNT_SW_PAGE_FAULTS},
+        };
+        int leader = -1;
+        for (int e = 0; e < PERF_EVENTS; ++e) {
+            perf_event_attr attr{};
+            attr.size = sizeof(attr);
+            attr.type = events[e].first;
+            attr.config = events[e].second;
+            attr.exclude_kernel = 1;
+            attr.exclude_hv = 1;
+            attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+            int fd = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, leader, 0));
+            if (fd < 0) continue;
+            if (leader < 0) leader = fd;
+            fds[e] = fd;
+            slot[e] = members++;
+        }
+    }
+
+    // Current totals, scaled up when the kernel had to multiplex the group
+    bool sample(PerfCounts& out) {
+        int leader = -1;
+        for (int e = 0; e < PERF_EVENTS && leader < 0; ++e)
+            if (slot[e] == 0) leader = fds[e];
+        if (leader < 0) return false;
+
+        uint64_t buf[3 + PERF_EVENTS];
+        ssize_t want = static_cast<ssize_t>((3 + members) * sizeof(uint64_t));
+        if (::read(leader, buf, sizeof(buf)) < want) return false;
+        double scale = buf[2] > 0 ? static_cast<double>(buf[1]) / buf[2] : 1.0;
+        for (int e = 0; e < PERF_EVENTS; ++e) {
+            if (slot[e] < 0) continue;
+            out.value[e] = static_cast<uint64_t>(buf[3 + slot[e]] * scale);
+            out.present |= 1u << e;
+        }
+        out.valid = true;
+        return true;
+    }
+};
+#endif
+
+// Counter totals of the calling thread; invalid when counting is off or unsupported
+inline PerfCounts perf_read() {
+    PerfCounts counts;
+#ifdef __linux__
+    if (!perf_counters_enabled) return counts;
+    thread_local PerfGroup group;
+    if (!group.opened) group.open();
+    group.sample(counts);
+#endif
+    return counts;
+}
+
+// ===================== Benchmark Log & Repeated-Run Statistics =====================
+// Every input size runs warmup_runs unmeasured times, then measured_runs measured times.
+// Stage timings (ns) are kept per (stage, input size, threads) and summarized as min,
+// median, p95, mean and stddev in benchmark_stats.json, one record per line, so results
+// from different builds can be compared by a script.
+
+struct BenchmarkEntry {
+    std::string part;
+    long long duration_ns;
+    PerfCounts counters;   // valid only with --perf-counters
+};
+
+inline std::vector<BenchmarkEntry> benchmark_log;
+
+inline int warmup_runs = 1;     // --warmup N
+inline int measured_runs = 5;   // --reps N
+
+struct SampleKey {
+    std::string stage;
+    int input_size;
+    unsigned int threads;
+    bool operator<(const SampleKey& o) const {
+        return std::tie(input_size, threads, stage) < std::tie(o.input_size, o.threads, o.stage);
+    }
+};
+
+inline std::map<SampleKey, std::vector<long long>> stage_samples;   // ns, one per measured run
+
+// Keep the stages of the run that just finished, plus its execution and wall time
+inline void record_run(int input_size, unsigned int threads, long long exec_ns, long long wall_ns) {
+    for (const auto& entry : benchmark_log)
+        stage_samples[{entry.part, input_size, threads}].push_back(entry.duration_ns);
+    stage_samples[{"Execution Time", input_size, threads}].push_back(exec_ns);
+    stage_samples[{"Wall Clock Time", input_size, threads}].push_back(wall_ns);
+}
+
+struct SampleStats {
+    size_t count = 0;
+    long long min_ns = 0;
+    double median_ns = 0;
+    long long p95_ns = 0;   // nearest-rank
+    double mean_ns = 0;
+    double stddev_ns = 0;   // sample standard deviation
+};
+
+inline SampleStats summarize(std::vector<long long> samples) {
+    SampleStats st;
+    st.count = samples.size();
+    if (samples.empty()) return st;
+    std::sort(samples.begin(), samples.end());
+    size_t n = samples.size();
+    st.min_ns = samples.front();
+    st.median_ns = n % 2 ? samples[n / 2] : (samples[n / 2 - 1] + samples[n / 2]) / 2.0;
+    st.p95_ns = samples[static_cast<size_t>(std::ceil(0.95 * n)) - 1];
+    for (long long s : samples) st.mean_ns += s;
+    st.mean_ns /= n;
+    for (long long s : samples) st.stddev_ns += (s - st.mean_ns) * (s - st.mean_ns);
+    st.stddev_ns = n > 1 ? std::sqrt(st.stddev_ns / (n - 1)) : 0.0;
+    return st;
+}
+
+inline double median_ms(const SampleKey& key) {
+    auto it = stage_samples.find(key);
+    return it == stage_samples.end() ? 0.0 : summarize(it->second).median_ns / 1e6;
+}
+
+inline void export_benchmark_stats(const std::string& program, const std::string& filename = "benchmark_stats.json") {
+    std::ofstream file(filename);
+    if (!file.is_open()) {
+        std::cerr << "❌ Failed to open " << filename << "\n";
+        return;
+    }
+    file << "{\n";
+    file << "  \"program\": \"" << program << "\",\n";
+    file << "  \"warmup_runs\": " << warmup_runs << ",\n";
+    file << "  \"measured_runs\": " << measured_runs << ",\n";
+    file << "  \"results\": [\n";
+    size_t i = 0;
+    for (const auto& [key, samples] : stage_samples) {
+        SampleStats st = summarize(samples);
+        file << "    {\"stage\": \"" << key.stage << "\", \"input_size\": " << key.input_size
+             << ", \"threads\": " << key.threads << ", \"samples\": " << st.count
+             << ", \"min_ns\": " << st.min_ns << ", \"median_ns\": " << (long long)st.median_ns
+             << ", \"p95_ns\": " << st.p95_ns << ", \"mean_ns\": " << (long long)st.mean_ns
+             << ", \"stddev_ns\": " << (long long)st.stddev_ns << "}"
+             << (++i < stage_samples.size() ? ",\n" : "\n");
+    }
+    file << "  ]\n}\n";
+    std::cout << "📊 Benchmark statistics saved to " << filename << "\n";
+}
+
+#endif
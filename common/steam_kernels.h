@@ -0,0 +1,319 @@
+// Parsing kernels of Sequential.cpp and parallel.cpp, kept side by side so kernel_bench
+// can time both variants on the same inputs without compiling either program.
+//
+// seq_kernels holds the baseline versions Sequential.cpp uses, par_kernels the ones
+// parallel.cpp uses (static regexes, in-place CSV escaping and so on). Each program pulls
+// its variant in with using-declarations; results must stay identical between the two.
+#ifndef STEAM_KERNELS_H
+#define STEAM_KERNELS_H
+
+#include <string>
+#include <string_view>
+#include <set>
+#include <sstream>
+#include <algorithm>
+#include <iterator>
+#include <regex>
+#include <cctype>
+#include <cmath>
+
+// ===================== System Requirement Specs =====================
+
+struct SystemSpec {
+    std::string os;
+    std::string cpu;
+    std::string gpu;
+    int ram_gb = 0;
+    int storage_gb = 0;
+};
+
+// Keep the most demanding value per field; strings compare lexicographically, so the
+// fold is order-independent
+inline void take_max(SystemSpec& base, const SystemSpec& current) {
+    if (base.ram_gb < current.ram_gb) base.ram_gb = current.ram_gb;
+    if (base.storage_gb < current.storage_gb) base.storage_gb = current.storage_gb;
+    if (base.os.empty() || current.os > base.os) base.os = current.os;
+    if (base.cpu.empty() || current.cpu > base.cpu) base.cpu = current.cpu;
+    if (base.gpu.empty() || current.gpu > base.gpu) base.gpu = current.gpu;
+}
+
+// ===================== Sequential Kernels =====================
+
+namespace seq_kernels {
+
+// Utility to escape quotes and wrap field in quotes for CSV
+inline std::string escape_csv(const std::string& input) {
+    std::string output = input;
+    size_t pos = 0;
+    while ((pos = output.find("\"", pos)) != std::string::npos) {
+        output.insert(pos, "\"");  // Double the quote
+        pos += 2;
+    }
+    return "\"" + output + "\"";
+}
+
+// Split genre fields into a deduplicated, whitespace-free set
+inline std::set<std::string> genre_tokens(const std::string& tags, const std::string& details, const std::string& genre) {
+    std::set<std::string> genre_set;
+    std::stringstream ss(tags + "," + details + "," + genre);
+    std::string token;
+    while (std::getline(ss, token, ',')) {
+        token.erase(std::remove_if(token.begin(), token.end(), ::isspace), token.end());
+        if (!token.empty()) genre_set.insert(token);
+    }
+    return genre_set;
+}
+
+// Merge genre fields
+inline std::string join_genres(const std::set<std::string>& genre_set) {
+    std::string result;
+    for (const auto& g : genre_set) {
+        if (!result.empty()) result += ", ";
+        result += g;
+    }
+    return result;
+}
+
+// Extract the last number before a '%' symbol
+inline float extract_review_percent(const std::string& text) {
+    size_t pos = text.rfind('%');
+    if (pos == std::string::npos) return -1.0f;
+
+    size_t start = pos;
+    while (start > 0 && (isdigit(text[start - 1]) || text[start - 1] == '.')) {
+        start--;
+    }
+
+    std::string num = text.substr(start, pos - start);
+    try {
+        return std::stof(num);
+    } catch (...) {
+        return -1.0f;
+    }
+}
+
+// Parse a price string, "free" → 0; NaN when no number can be read
+inline float parse_price(const std::string& text) {
+    std::string price = text;
+    std::transform(price.begin(), price.end(), price.begin(), ::tolower);
+    if (price.empty()) return NAN;
+    if (price.find("free") != std::string::npos) return 0.0f;
+
+    price.erase(std::remove_if(price.begin(), price.end(), [](char c) {
+        return !(isdigit(c) || c == '.' || c == '-');
+    }), price.end());
+    if (price.empty()) return NAN;
+
+    try {
+        return std::stof(price);
+    } catch (...) {
+        return NAN;
+    }
+}
+
+// Extract RAM in GB
+inline int extract_ram(const std::string& text) {
+    std::regex ram_pattern(R"((\d{1,3})\s*(GB|Mb|MB|gb|mb))");
+    std::smatch match;
+    if (std::regex_search(text, match, ram_pattern)) {
+        try {
+            int value = std::stoi(match[1].str());
+            std::string unit = match[2].str();
+            if (unit == "MB" || unit == "mb" || unit == "Mb") value /= 1024;
+            if (value > 0 && value <= 256) return value;  // Limit to 256 GB
+        } catch (...) {
+            return 0;
+        }
+    }
+    return 0;
+}
+
+// Extract Storage in GB
+inline int extract_storage(const std::string& text) {
+    std::regex storage_pattern(R"((\d{1,4})\s*(GB|Gb|MB|Mb))");
+    std::smatch match;
+    if (std::regex_search(text, match, storage_pattern)) {
+        try {
+            int value = std::stoi(match[1].str());
+            std::string unit = match[2].str();
+            if (unit == "MB" || unit == "mb") value /= 1024;
+            if (value > 0 && value <= 2000) return value;  // Limit to 2TB
+        } catch (...) {
+            return 0;
+        }
+    }
+    return 0;
+}
+
+// Generic helper: find line containing keyword
+inline std::string extract_line(const std::string& text, const std::string& key) {
+    std::istringstream iss(text);
+    std::string line;
+    while (std::getline(iss, line)) {
+        if (line.find(key) != std::string::npos) {
+            return line;
+        }
+    }
+    return "";
+}
+
+// Extract all specs from a single text blob
+inline SystemSpec parse_spec_block(const std::string& block) {
+    SystemSpec spec;
+    std::string line;
+
+    line = extract_line(block, "OS");
+    if (!line.empty()) spec.os = line;
+
+    line = extract_line(block, "Processor");
+    if (line.empty()) line = extract_line(block, "CPU");
+    if (!line.empty()) spec.cpu = line;
+
+    line = extract_line(block, "Graphics");
+    if (line.empty()) line = extract_line(block, "GPU");
+    if (!line.empty()) spec.gpu = line;
+
+    spec.ram_gb = extract_ram(block);
+    spec.storage_gb = extract_storage(block);
+
+    return spec;
+}
+
+}  // namespace seq_kernels
+
+// ===================== Parallel Kernels =====================
+
+namespace par_kernels {
+
+// Append a quoted CSV field, doubling embedded quotes
+inline void append_csv_field(std::string& out, std::string_view value) {
+    out += '"';
+    size_t start = 0;
+    for (size_t pos; (pos = value.find('"', start)) != std::string_view::npos; start = pos + 1) {
+        out.append(value.data() + start, pos + 1 - start);
+        out += '"';
+    }
+    out.append(value.data() + start, value.size() - start);
+    out += '"';
+}
+
+// Extract the last number before a '%' symbol (e.g., "Very Positive,(1,234),- 95% of ...")
+inline float extract_review_percent(const std::string& input) {
+    size_t percent_pos = input.rfind('%');
+    if (percent_pos == std::string::npos) return -1.0f;
+    size_t start = percent_pos;
+    while (start > 0 && (isdigit(input[start - 1]) || input[start - 1] == '.')) start--;
+    try {
+        return std::stof(input.substr(start, percent_pos - start));
+    } catch (...) {
+        return -1.0f;
+    }
+}
+
+// Parse price field, set "free" to 0; NaN when no number can be read
+inline float parse_price(const std::string& price) {
+    std::string lower = price;
+    std::transform(lower.begin(), lower.end(), lower.begin(), ::tolower);
+    if (lower.empty()) return NAN;
+    if (lower.find("free") != std::string::npos) return 0.0f;
+    lower.erase(std::remove_if(lower.begin(), lower.end(), [](char c) {
+        return !(isdigit(c) || c == '.' || c == '-');
+    }), lower.end());
+    if (lower.empty()) return NAN;
+    try {
+        return std::stof(lower);
+    } catch (...) {
+        return NAN;
+    }
+}
+
+// Split genre tags from 3 sources into a deduplicated, whitespace-free set
+inline std::set<std::string> genre_tokens(const std::string& tags, const std::string& details, const std::string& genre) {
+    std::set<std::string> all;
+    std::stringstream ss(tags + "," + details + "," + genre);
+    std::string token;
+    while (std::getline(ss, token, ',')) {
+        std::string trimmed;
+        std::remove_copy_if(token.begin(), token.end(), std::back_inserter(trimmed), ::isspace);
+        if (!trimmed.empty()) all.insert(trimmed);
+    }
+    return all;
+}
+
+inline std::string join_genres(const std::set<std::string>& all) {
+    std::string result;
+    for (const auto& g : all) {
+        if (!result.empty()) result += ", ";
+        result += g;
+    }
+    return result;
+}
+
+// Merge genre tags from 3 sources into deduplicated string
+inline std::string merge_genres(const std::string& tags, const std::string& details, const std::string& genre) {
+    return join_genres(genre_tokens(tags, details, genre));
+}
+
+// Extract RAM in GB (first "N GB" / "N MB" in the block, up to 256 GB)
+inline int extract_ram(const std::string& text) {
+    static const std::regex ram_pattern(R"((\d{1,3})\s*(GB|Mb|MB|gb|mb))");
+    std::smatch match;
+    if (std::regex_search(text, match, ram_pattern)) {
+        try {
+            int value = std::stoi(match[1].str());
+            std::string unit = match[2].str();
+            if (unit == "MB" || unit == "mb" || unit == "Mb") value /= 1024;
+            if (value > 0 && value <= 256) return value;
+        } catch (...) {
+            return 0;
+        }
+    }
+    return 0;
+}
+
+// Extract storage in GB (first "N GB" / "N MB" in the block, up to 2 TB)
+inline int extract_storage(const std::string& text) {
+    static const std::regex storage_pattern(R"((\d{1,4})\s*(GB|Gb|MB|Mb))");
+    std::smatch match;
+    if (std::regex_search(text, match, storage_pattern)) {
+        try {
+            int value = std::stoi(match[1].str());
+            std::string unit = match[2].str();
+            if (unit == "MB" || unit == "mb") value /= 1024;
+            if (value > 0 && value <= 2000) return value;
+        } catch (...) {
+            return 0;
+        }
+    }
+    return 0;
+}
+
+// First line of the block containing key, or ""
+inline std::string extract_line(const std::string& text, const std::string& key) {
+    std::istringstream iss(text);
+    std::string line;
+    while (std::getline(iss, line)) {
+        if (line.find(key) != std::string::npos) return line;
+    }
+    return "";
+}
+
+// Parse each field of one requirements block
+inline SystemSpec parse_spec_block(const std::string& block) {
+    SystemSpec spec;
+    spec.os = extract_line(block, "OS");
+
+    spec.cpu = extract_line(block, "Processor");
+    if (spec.cpu.empty()) spec.cpu = extract_line(block, "CPU");
+
+    spec.gpu = extract_line(block, "Graphics");
+    if (spec.gpu.empty()) spec.gpu = extract_line(block, "GPU");
+
+    spec.ram_gb = extract_ram(block);
+    spec.storage_gb = extract_storage(block);
+    return spec;
+}
+
+}  // namespace par_kernels
+
+#endif
@@ -0,0 +1,185 @@
+import argparse
+import csv
+import math
+import os
+import shlex
+import shutil
+import sqlite3
+import subprocess
+import sys
+import tempfile
+
+# Differential correctness check: runs Sequential and parallel on the same database and
+# row limit, then compares every exported CSV field by field. Numeric fields may differ by
+# the tolerance (summation order changes with the thread count); everything else must be
+# equal. Exit code 0 = equivalent, 1 = outputs differ, 2 = a program or setup step failed.
+#   python differential_check.py --seq Sequential.exe --par parallel.exe --db steam.db
+#   python differential_check.py --seq ... --par ... --rows 50000 --par-args="--pipeline --compact"
+# Without --db a synthetic database is generated with generate_steam_data.py (offline).
+# --blank-column empties one column on a copy of the database first, e.g. developer with
+# --memory-budget: publisher groups then spill to run files while developer groups never do.
+
+# === Settings ===
+here = os.path.dirname(os.path.abspath(__file__))
+parser = argparse.ArgumentParser(description="Compare the CSV outputs of Sequential and parallel.")
+parser.add_argument("--seq", required=True, help="Sequential executable")
+parser.add_argument("--par", required=True, help="parallel executable")
+parser.add_argument("--db", default=None, help="steam_games database (default: generate one)")
+parser.add_argument("--rows", type=int, default=20000, help="rows to generate when --db is not given")
+parser.add_argument("--seed", type=int, default=42, help="generator seed when --db is not given")
+parser.add_argument("--limit", default=None, help="row limit for both runs (default: --rows, or 40000 with --db)")
+parser.add_argument("--seq-args", default="", help="extra Sequential flags, e.g. --seq-args=\"--compact\"")
+parser.add_argument("--par-args", default="", help="extra parallel flags, e.g. --par-args=\"--pipeline --threads 8\"")
+parser.add_argument("--rel-tol", type=float, default=1e-5, help="relative tolerance for numeric fields")
+parser.add_argument("--abs-tol", type=float, default=1e-4, help="absolute tolerance for numeric fields")
+parser.add_argument("--results-only", action="store_true",
+                    help="skip debug_raw_rows.csv / formatted_debug.csv (e.g. for --memory-budget runs)")
+parser.add_argument("--max-report", type=int, default=10, help="mismatches printed per file")
+parser.add_argument("--work-dir", default=None, help="keep run directories here (default: a temp dir)")
+parser.add_argument("--blank-column", action="append", default=[],
+                    help="steam_games column to empty on a copy of the database (repeatable)")
+args = parser.parse_args()
+
+generator = os.path.join(here, "..", "parallel_final", "parallel_final", "generate_steam_data.py")
+
+# Every CSV both programs write with --export; analysis files first
+RESULT_FILES = [
+    "system_requirements_summary.csv",
+    "top_5_games.csv",
+    "top_5_genres.csv",
+    "developer_stats.csv",
+    "publisher_stats.csv",
+]
+DEBUG_FILES = [
+    "debug_raw_rows.csv",
+    "formatted_debug.csv",
+]
+
+
+def as_number(text):
+    """Float value of a numeric field, or None for text (including empty fields)."""
+    try:
+        value = float(text)
+    except ValueError:
+        return None
+    return value if text.strip() == text and text != "" else None
+
+
+def fields_equal(a, b):
+    if a == b:
+        return True
+    x, y = as_number(a), as_number(b)
+    if x is None or y is None:
+        return False
+    if math.isnan(x) or math.isnan(y):
+        return math.isnan(x) and math.isnan(y)
+    return math.isclose(x, y, rel_tol=args.rel_tol, abs_tol=args.abs_tol)
+
+
+def read_csv(path):
+    with open(path, newline="", encoding="utf-8", errors="replace") as f:
+        return list(csv.reader(f))
+
+
+def compare_file(name, seq_dir, par_dir, mismatches):
+    """Append (file, row, column, sequential, parallel) for every differing field; returns the count."""
+    seq_path, par_path = os.path.join(seq_dir, name), os.path.join(par_dir, name)
+    missing = [who for who, p in (("sequential", seq_path), ("parallel", par_path)) if not os.path.exists(p)]
+    if missing:
+        mismatches.append((name, "", "", "missing in " + " and ".join(missing), ""))
+        return 1
+
+    seq_rows, par_rows = read_csv(seq_path), read_csv(par_path)
+    header = seq_rows[0] if seq_rows else []
+    found = 0
+    if len(seq_rows) != len(par_rows):
+        mismatches.append((name, "", "(row count)", len(seq_rows) - 1, len(par_rows) - 1))
+        found += 1
+    for r, (a, b) in enumerate(zip(seq_rows, par_rows)):
+        if len(a) != len(b):
+            mismatches.append((name, r, "(field count)", len(a), len(b)))
+            found += 1
+            continue
+        for c, (x, y) in enumerate(zip(a, b)):
+            if not fields_equal(x, y):
+                column = "(header)" if r == 0 else (header[c] if c < len(header) else str(c))
+                mismatches.append((name, r, column, x, y))
+                found += 1
+    return found
+
+
+def run_program(label, exe, extra, db, limit, out_dir):
+    os.makedirs(out_dir, exist_ok=True)
+    for name in os.listdir(out_dir):   # a stale file from an earlier run must not pass for this one
+        if name.endswith(".csv"):
+            os.remove(os.path.join(out_dir, name))
+    cmd = [os.path.abspath(exe), "--db", os.path.abspath(db), "--limits", str(limit),
+           "--warmup", "0", "--reps", "1", "--export"] + shlex.split(extra)
+    print(f"⚙️ Running {label}: {' '.join(cmd[1:])}")
+    with open(os.path.join(out_dir, "run.log"), "w", encoding="utf-8") as log:
+        result = subprocess.run(cmd, cwd=out_dir, stdout=log, stderr=subprocess.STDOUT)
+    if result.returncode != 0:
+        print(f"❌ {label} exited with code {result.returncode}; see {os.path.join(out_dir, 'run.log')}")
+        sys.exit(2)
+
+
+# === Step 1: Pick the input database ===
+work_dir = os.path.abspath(args.work_dir) if args.work_dir else tempfile.mkdtemp(prefix="steam_diff_")
+os.makedirs(work_dir, exist_ok=True)
+db = args.db
+if db is None:
+    db = os.path.join(work_dir, f"steam_synthetic_{args.rows}_{args.seed}.db")
+    if not os.path.exists(db):
+        gen = subprocess.run([sys.executable, generator, "--rows", str(args.rows), "--seed", str(args.seed),
+                              "--out", db])
+        if gen.returncode != 0:
+            print("❌ Could not generate the synthetic database.")
+            sys.exit(2)
+elif not os.path.exists(db):
+    print(f"❌ Database '{db}' not found.")
+    sys.exit(2)
+limit = args.limit or (args.rows if args.db is None else 40000)
+
+if args.blank_column:
+    blanked = os.path.join(work_dir, "blanked_" + "_".join(args.blank_column) + ".db")
+    shutil.copyfile(db, blanked)
+    con = sqlite3.connect(blanked)
+    columns = {row[1] for row in con.execute("PRAGMA table_info(steam_games)")}
+    for column in args.blank_column:
+        if column not in columns:
+            print(f"❌ steam_games has no column '{column}'.")
+            sys.exit(2)
+        con.execute(f'UPDATE steam_games SET "{column}" = \'\'')
+    con.commit()
+    con.close()
+    db = blanked
+
+# === Step 2: Run both programs on the same rows ===
+seq_dir, par_dir = os.path.join(work_dir, "sequential"), os.path.join(work_dir, "parallel")
+run_program("Sequential", args.seq, args.seq_args, db, limit, seq_dir)
+run_program("parallel", args.par, args.par_args, db, limit, par_dir)
+
+# === Step 3: Compare every exported file field by field ===
+files = RESULT_FILES + ([] if args.results_only else DEBUG_FILES)
+mismatches = []
+for name in files:
+    start = len(mismatches)
+    found = compare_file(name, seq_dir, par_dir, mismatches)
+    if found == 0:
+        print(f"✅ {name}: identical")
+        continue
+    print(f"❌ {name}: {found} differing field(s)")
+    for file, row, column, x, y in mismatches[start:start + args.max_report]:
+        where = f"row {row}, {column}" if row != "" else column
+        print(f"   {where}: sequential={str(x)[:60]!r} parallel={str(y)[:60]!r}")
+
+report = os.path.join(work_dir, "differential_report.csv")
+with open(report, "w", newline="", encoding="utf-8") as f:
+    writer = csv.writer(f)
+    writer.writerow(["File", "Row", "Column", "Sequential", "Parallel"])
+    writer.writerows(mismatches)
+
+if mismatches:
+    print(f"❌ Outputs differ ({len(mismatches)} fields); full list in '{report}'")
+    sys.exit(1)
+print(f"✅ Sequential and parallel outputs are equivalent on {limit} rows of '{db}'")
@@ -0,0 +1,41 @@
+@echo off
+chcp 65001 > nul
+
+:: Compile both programs with g++ (sqlite3.o is built by run_sequential.bat / run_parallel.bat)
+echo ⚙️ Compiling Sequential.cpp and parallel.cpp with g++...
+g++ -std=c++17 -O2 ../sequential_final/sequential_final/Sequential.cpp ../sequential_final/sequential_final/sqlite3.o -lstdc++ -o Sequential.exe
+if errorlevel 1 (
+    echo ❌ Compilation of Sequential.cpp failed.
+    pause
+    exit /b 1
+)
+g++ -std=c++17 -O2 ../parallel_final/parallel_final/parallel.cpp ../parallel_final/parallel_final/sqlite3.o -lstdc++ -o parallel.exe
+if errorlevel 1 (
+    echo ❌ Compilation of parallel.cpp failed.
+    pause
+    exit /b 1
+)
+
+echo ✅ Compilation successful!
+
+:: Same rows through both programs, once per parallel execution mode
+set CHECK=python differential_check.py --seq Sequential.exe --par parallel.exe --rows 20000 --work-dir differential_runs
+%CHECK% || goto failed
+%CHECK% --seq-args="--compact" --par-args="--compact" || goto failed
+%CHECK% --par-args="--pipeline --threads 1,4" || goto failed
+:: Descending limits: a smaller run must not keep results from the larger one before it
+%CHECK% --limit 20000,100 || goto failed
+%CHECK% --par-args="--memory-budget 1" --results-only || goto failed
+%CHECK% --par-args="--memory-budget 1" --results-only --blank-column developer || goto failed
+if exist ../parallel_final/parallel_final/steam.db (
+    %CHECK% --db ../parallel_final/parallel_final/steam.db || goto failed
+)
+
+echo ✅ All differential checks passed.
+pause
+exit /b 0
+
+:failed
+echo ❌ Differential check failed; see differential_runs\differential_report.csv
+pause
+exit /b 1
@@ -0,0 +1,324 @@
+// Microbenchmarks for the parsing kernels of Sequential.cpp and parallel.cpp.
+//
+// Both variants of every kernel live in common/steam_kernels.h (seq_kernels and
+// par_kernels), which the two programs call through using-declarations, so each kernel
+// is timed in its sequential and parallel variant on the same inputs without compiling
+// either program into this one.
+//
+//   kernel_bench --sample 2000 [--db steam.db]    sample steam.db into kernel_fixture.txt
+//   kernel_bench [--reps 5] [--min-ms 100]        time every kernel on kernel_fixture.txt
+//
+// Results go to the console and to kernel_bench.csv (ns/op and MB/s of input per kernel).
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <cstdint>
+#include <cstdio>
+#include <sqlite3.h>
+#include "../common/steam_common.h"
+#include "../common/steam_kernels.h"
+
+// ===================== Part 1: Fixture =====================
+
+// The raw fields the kernels read, sampled from steam.db
+struct FixtureRow {
+    std::string name;
+    std::string developer;
+    std::string recent_reviews;
+    std::string all_reviews;
+    std::string popular_tags;
+    std::string game_details;
+    std::string genre;
+    std::string minimum_requirements;
+    std::string recommended_requirements;
+    std::string original_price;
+};
+
+const std::vector<std::pair<const char*, std::string FixtureRow::*>> FIXTURE_FIELDS = {
+    {"name",                     &FixtureRow::name},
+    {"developer",                &FixtureRow::developer},
+    {"recent_reviews",           &FixtureRow::recent_reviews},
+    {"all_reviews",              &FixtureRow::all_reviews},
+    {"popular_tags",             &FixtureRow::popular_tags},
+    {"game_details",             &FixtureRow::game_details},
+    {"genre",                    &FixtureRow::genre},
+    {"minimum_requirements",     &FixtureRow::minimum_requirements},
+    {"recommended_requirements", &FixtureRow::recommended_requirements},
+    {"original_price",           &FixtureRow::original_price},
+};
+
+const char* FIXTURE_MAGIC = "steam-kernel-fixture v1";
+
+std::string fixture_path = "kernel_fixture.txt";
+std::string db_path = "steam.db";
+size_t sample_rows = 0;       // --sample N: write a fixture instead of benchmarking
+int measured_reps = 5;
+double min_sample_ms = 100;   // each sample repeats the corpus until it runs this long
+
+// Fields are stored as "<length>\n<bytes>\n" so embedded newlines and commas survive
+bool write_fixture(const std::vector<FixtureRow>& rows) {
+    std::ofstream file(fixture_path, std::ios::binary);
+    if (!file.is_open()) {
+        std::cerr << "❌ Could not open " << fixture_path << " for writing.\n";
+        return false;
+    }
+    file << FIXTURE_MAGIC << "\n" << rows.size() << "\n";
+    for (const auto& row : rows) {
+        for (const auto& [name, field] : FIXTURE_FIELDS) {
+            const std::string& value = row.*field;
+            file << value.size() << "\n";
+            file.write(value.data(), value.size());
+            file << "\n";
+        }
+    }
+    return true;
+}
+
+bool read_fixture(std::vector<FixtureRow>& rows) {
+    std::ifstream file(fixture_path, std::ios::binary);
+    std::string line;
+    if (!file.is_open() || !std::getline(file, line) || line != FIXTURE_MAGIC) {
+        std::cerr << "❌ " << fixture_path << " is missing or not a kernel fixture (create it with --sample N).\n";
+        return false;
+    }
+    size_t count = 0;
+    file >> count;
+    file.ignore(1);
+    rows.assign(count, {});
+    for (auto& row : rows) {
+        for (const auto& [name, field] : FIXTURE_FIELDS) {
+            size_t length = 0;
+            file >> length;
+            file.ignore(1);
+            std::string& value = row.*field;
+            value.resize(length);
+            file.read(value.data(), length);
+            file.ignore(1);
+        }
+        if (!file) {
+            std::cerr << "❌ " << fixture_path << " is truncated.\n";
+            return false;
+        }
+    }
+    return true;
+}
+
+// Evenly spaced rows across the whole table, so the corpus keeps the real mix of formats
+bool sample_fixture() {
+    sqlite3* db = nullptr;
+    if (sqlite3_open(db_path.c_str(), &db) != SQLITE_OK) {
+        std::cerr << "❌ Failed to open " << db_path << ": " << sqlite3_errmsg(db) << "\n";
+        sqlite3_close(db);
+        return false;
+    }
+    std::vector<RawSteamRow> raw;
+    sqlite3_stmt* stmt;
+    if (sqlite3_prepare_v2(db, "SELECT * FROM steam_games;", -1, &stmt, nullptr) != SQLITE_OK) {
+        std::cerr << "❌ Failed to prepare SELECT: " << sqlite3_errmsg(db) << "\n";
+        sqlite3_close(db);
+        return false;
+    }
+    while (sqlite3_step(stmt) == SQLITE_ROW) raw.push_back(read_raw_row(stmt));
+    sqlite3_finalize(stmt);
+    sqlite3_close(db);
+    if (raw.empty()) return false;
+
+    size_t total = raw.size();
+    size_t count = std::min(sample_rows, total);
+    std::vector<FixtureRow> rows;
+    rows.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        const auto& row = raw[i * total / count];
+        rows.push_back({row.name, row.developer, row.recent_reviews, row.all_reviews, row.popular_tags,
+                        row.game_details, row.genre, row.minimum_requirements,
+                        row.recommended_requirements, row.original_price});
+    }
+    if (!write_fixture(rows)) return false;
+    std::cout << "✅ Sampled " << rows.size() << " of " << total << " rows into " << fixture_path << "\n";
+    return true;
+}
+
+// ===================== Part 2: Kernel Timing =====================
+
+struct KernelResult {
+    std::string kernel;
+    std::string variant;
+    std::string function;
+    size_t inputs = 0;
+    size_t bytes = 0;        // input bytes per pass over the corpus
+    double ns_per_op = 0;    // median over measured_reps
+    double mb_per_s = 0;
+};
+
+std::vector<KernelResult> kernel_results;
+volatile uint64_t sink = 0;   // keeps kernel results alive past the optimizer
+
+// Inputs of the genre merge, which reads three fields at once
+struct GenreInput {
+    const std::string* tags;
+    const std::string* details;
+    const std::string* genre;
+};
+
+size_t input_bytes(const std::string* s) { return s->size(); }
+size_t input_bytes(const GenreInput& g) { return g.tags->size() + g.details->size() + g.genre->size(); }
+
+uint64_t fold(float value) {
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof bits);
+    return bits;
+}
+
+// Times fn over every input: one warmup pass, then measured_reps samples of whole passes
+template <typename Input, typename Fn>
+void run_kernel(const std::string& kernel, const std::string& variant, const std::string& function,
+                const std::vector<Input>& inputs, Fn fn) {
+    if (inputs.empty()) return;
+    KernelResult result{kernel, variant, function, inputs.size()};
+    for (const auto& input : inputs) result.bytes += input_bytes(input);
+
+    auto pass = [&]() {
+        uint64_t acc = 0;
+        for (const auto& input : inputs) acc += fn(input);
+        sink = sink + acc;
+    };
+    pass();
+
+    std::vector<double> samples;
+    for (int rep = 0; rep < measured_reps; ++rep) {
+        size_t passes = 0;
+        auto start = std::chrono::steady_clock::now();
+        double elapsed_ns = 0;
+        do {
+            pass();
+            ++passes;
+            elapsed_ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+        } while (elapsed_ns < min_sample_ms * 1e6);
+        samples.push_back(elapsed_ns / (passes * inputs.size()));
+    }
+    std::sort(samples.begin(), samples.end());
+    result.ns_per_op = samples[samples.size() / 2];
+    double ns_per_pass = result.ns_per_op * inputs.size();
+    result.mb_per_s = result.bytes / ns_per_pass * 1e3;   // bytes/ns → MB/s
+
+    printf("   %-24s %-10s %-26s %10.1f ns/op %10.2f MB/s\n", kernel.c_str(), variant.c_str(),
+           function.c_str(), result.ns_per_op, result.mb_per_s);
+    kernel_results.push_back(result);
+}
+
+uint64_t fold(const SystemSpec& s) { return s.ram_gb + s.storage_gb + s.os.size() + s.cpu.size() + s.gpu.size(); }
+
+void run_all_kernels(const std::vector<FixtureRow>& rows) {
+    std::vector<const std::string*> reviews, prices, blocks, text_fields;
+    std::vector<GenreInput> genres;
+    for (const auto& row : rows) {
+        reviews.push_back(&row.all_reviews);
+        reviews.push_back(&row.recent_reviews);
+        prices.push_back(&row.original_price);
+        genres.push_back({&row.popular_tags, &row.game_details, &row.genre});
+        blocks.push_back(&row.minimum_requirements);
+        blocks.push_back(&row.recommended_requirements);
+        for (auto field : {&FixtureRow::name, &FixtureRow::developer, &FixtureRow::popular_tags,
+                           &FixtureRow::minimum_requirements})
+            text_fields.push_back(&(row.*field));
+    }
+
+    std::cout << "⏱️ Timing kernels (" << measured_reps << " reps, >= " << min_sample_ms << " ms each)...\n";
+
+    run_kernel("extract_review_percent", "sequential", "extract_review_percent", reviews,
+               [](const std::string* s) { return fold(seq_kernels::extract_review_percent(*s)); });
+    run_kernel("extract_review_percent", "parallel", "extract_review_percent", reviews,
+               [](const std::string* s) { return fold(par_kernels::extract_review_percent(*s)); });
+
+    run_kernel("parse_price", "sequential", "parse_price", prices,
+               [](const std::string* s) { return fold(seq_kernels::parse_price(*s)); });
+    run_kernel("parse_price", "parallel", "parse_price", prices,
+               [](const std::string* s) { return fold(par_kernels::parse_price(*s)); });
+
+    run_kernel("merge_genres", "sequential", "join_genres(genre_tokens)", genres, [](const GenreInput& g) {
+        return (uint64_t)seq_kernels::join_genres(seq_kernels::genre_tokens(*g.tags, *g.details, *g.genre)).size();
+    });
+    run_kernel("merge_genres", "parallel", "merge_genres", genres, [](const GenreInput& g) {
+        return (uint64_t)par_kernels::merge_genres(*g.tags, *g.details, *g.genre).size();
+    });
+
+    run_kernel("extract_ram", "sequential", "extract_ram", blocks,
+               [](const std::string* s) { return (uint64_t)seq_kernels::extract_ram(*s); });
+    run_kernel("extract_ram", "parallel", "extract_ram", blocks,
+               [](const std::string* s) { return (uint64_t)par_kernels::extract_ram(*s); });
+
+    run_kernel("extract_storage", "sequential", "extract_storage", blocks,
+               [](const std::string* s) { return (uint64_t)seq_kernels::extract_storage(*s); });
+    run_kernel("extract_storage", "parallel", "extract_storage", blocks,
+               [](const std::string* s) { return (uint64_t)par_kernels::extract_storage(*s); });
+
+    run_kernel("parse_spec_block", "sequential", "parse_spec_block", blocks,
+               [](const std::string* s) { return fold(seq_kernels::parse_spec_block(*s)); });
+    run_kernel("parse_spec_block", "parallel", "parse_spec_block", blocks,
+               [](const std::string* s) { return fold(par_kernels::parse_spec_block(*s)); });
+
+    run_kernel("escape_csv", "sequential", "escape_csv", text_fields,
+               [](const std::string* s) { return (uint64_t)seq_kernels::escape_csv(*s).size(); });
+    std::string line;   // reused like a CsvLine buffer
+    run_kernel("escape_csv", "parallel", "append_csv_field", text_fields, [&line](const std::string* s) {
+        line.clear();
+        par_kernels::append_csv_field(line, *s);
+        return (uint64_t)line.size();
+    });
+}
+
+void export_kernel_results(const std::string& filename = "kernel_bench.csv") {
+    std::ofstream file(filename);
+    if (!file.is_open()) {
+        std::cerr << "❌ Could not open " << filename << " for writing.\n";
+        return;
+    }
+    file << "Kernel,Variant,Function,Inputs,Bytes,ns/op,MB/s\n";
+    for (const auto& r : kernel_results) {
+        file << r.kernel << "," << r.variant << "," << r.function << "," << r.inputs << ","
+             << r.bytes << "," << r.ns_per_op << "," << r.mb_per_s << "\n";
+    }
+    std::cout << "📄 Kernel timings saved to " << filename << "\n";
+}
+
+// ===================== Part 3: Main =====================
+
+bool parse_args(int argc, char* argv[]) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool has_value = i + 1 < argc;
+        if (arg == "--sample" && has_value) {
+            sample_rows = std::stoul(argv[++i]);
+        } else if (arg == "--db" && has_value) {
+            db_path = argv[++i];
+        } else if (arg == "--fixture" && has_value) {
+            fixture_path = argv[++i];
+        } else if (arg == "--reps" && has_value) {
+            measured_reps = std::max(1, std::stoi(argv[++i]));
+        } else if (arg == "--min-ms" && has_value) {
+            min_sample_ms = std::stod(argv[++i]);
+        } else {
+            std::cerr << "Usage: " << argv[0] << " [--sample N] [--db PATH] [--fixture PATH]"
+                      << " [--reps N] [--min-ms MS]\n";
+            return false;
+        }
+    }
+    return true;
+}
+
+int main(int argc, char* argv[]) {
+    if (!parse_args(argc, argv)) return 1;
+    if (sample_rows > 0) return sample_fixture() ? 0 : 1;
+
+    std::vector<FixtureRow> rows;
+    if (!read_fixture(rows)) return 1;
+    std::cout << "✅ Loaded " << rows.size() << " fixture rows from " << fixture_path << "\n";
+
+    run_all_kernels(rows);
+    export_kernel_results();
+    return 0;
+}
@@ -0,0 +1,34 @@
+@echo off
+chcp 65001 > nul
+
+:: Compile kernel_bench.cpp with g++ (both kernel variants come from common/steam_kernels.h)
+echo ⚙️ Compiling kernel_bench.cpp with g++...
+g++ -std=c++17 -O2 -I../parallel_final/parallel_final kernel_bench.cpp ../parallel_final/parallel_final/sqlite3.o -lstdc++ -o kernel_bench.exe
+if errorlevel 1 (
+    echo ❌ Compilation of kernel_bench.cpp failed.
+    pause
+    exit /b 1
+)
+
+echo ✅ Compilation successful!
+
+:: Sample the fixture once from steam.db, then time every kernel on it
+if not exist kernel_fixture.txt (
+    echo ⚙️ Sampling kernel_fixture.txt from steam.db...
+    kernel_bench.exe --sample 2000 --db ../parallel_final/parallel_final/steam.db
+    if errorlevel 1 (
+        echo ❌ Sampling the fixture failed.
+        pause
+        exit /b 1
+    )
+)
+
+echo ⚙️ Running the kernel benchmarks...
+kernel_bench.exe
+if errorlevel 1 (
+    echo ❌ Kernel benchmark failed.
+    pause
+    exit /b 1
+)
+
+pause
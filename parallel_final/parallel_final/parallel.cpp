@@ -7,7 +7,24 @@
 #include <set>
 #include <sstream>
 #include <algorithm>
+#ifdef _WIN32
 #include <windows.h>
+#else
+#include <sched.h>
+#include <pthread.h>
+#endif
+#ifdef __linux__
+#include <unistd.h>
+#include <cerrno>
+#include <csignal>
+#include <cxxabi.h>
+#include <execinfo.h>
+#include <link.h>
+#include <sys/time.h>
+#include <fcntl.h>
+#include <spawn.h>
+#include <sys/wait.h>
+#endif
 #include <sqlite3.h>
 #include <regex>
 #include <unordered_map>
@@ -15,9 +32,40 @@
 #include <thread>
 #include <mutex>
 #include <cmath>
+#include <deque>
+#include <string_view>
+#include <cstdint>
+#include <array>
+#include <functional>
+#include <cstring>
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <cstdio>
+#include <type_traits>
+#include <filesystem>
+#include <climits>
+#include <cstdlib>
+#include <tuple>
+#include <queue>
+#include <iomanip>
+#include "../../common/steam_common.h"
+#include "../../common/steam_kernels.h"
 
 using namespace std;
 
+// -- Parsing kernels; kernel_bench times them against Sequential.cpp's
+using par_kernels::append_csv_field;
+using par_kernels::extract_review_percent;
+using par_kernels::parse_price;
+using par_kernels::genre_tokens;
+using par_kernels::join_genres;
+using par_kernels::merge_genres;
+using par_kernels::extract_ram;
+using par_kernels::extract_storage;
+using par_kernels::extract_line;
+using par_kernels::parse_spec_block;
+
 // Optional: Detect parallel mode (for logs)
 void show_cpu_info() {
     unsigned int threads = std::thread::hardware_concurrency();
@@ -26,29 +74,40 @@ void show_cpu_info() {
     std::cout << "🧠 Logical Processor Count: " << threads << "\n";
 }
 
-// Struct to hold raw database rows
-struct RawSteamRow {
-    std::string url;
-    std::string types;
-    std::string name;
-    std::string desc_snippet;
-    std::string recent_reviews;
-    std::string all_reviews;
-    std::string release_date;
-    std::string developer;
-    std::string publisher;
-    std::string popular_tags;
-    std::string game_details;
-    std::string languages;
-    std::string achievements;
-    std::string genre;
-    std::string game_description;
-    std::string mature_content;
-    std::string minimum_requirements;
-    std::string recommended_requirements;
-    std::string original_price;
-    std::string discount_price;
-};
+// ===================== CPU Affinity =====================
+// Thin layer over the Windows affinity masks and sched_setaffinity / pthread_setaffinity_np,
+// used by --cpus to restrict the process and pin each pool worker to one core.
+
+std::vector<int> cpu_list;   // --cpus LIST; worker w runs on cpu_list[w % size]
+
+// Restrict the process to 'cpus'; threads started afterwards inherit the mask
+bool pin_process(const std::vector<int>& cpus) {
+#ifdef _WIN32
+    DWORD_PTR mask = 0;
+    for (int c : cpus) mask |= DWORD_PTR(1) << c;
+    return SetProcessAffinityMask(GetCurrentProcess(), mask) != 0;
+#else
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (int c : cpus) CPU_SET(c, &set);
+    return sched_setaffinity(0, sizeof(set), &set) == 0;
+#endif
+}
+
+// Pin the calling thread to a single CPU. std::thread::native_handle() is not a Win32
+// HANDLE under every toolchain (winpthreads), so workers pin themselves.
+bool pin_current_thread(int cpu) {
+#ifdef _WIN32
+    if (cpu < 0 || cpu >= static_cast<int>(sizeof(DWORD_PTR) * 8)) return false;
+    return SetThreadAffinityMask(GetCurrentThread(), DWORD_PTR(1) << cpu) != 0;
+#else
+    if (cpu < 0 || cpu >= CPU_SETSIZE) return false;
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#endif
+}
 
 // Global database connection
 sqlite3* db;
@@ -56,12 +115,6 @@ sqlite3* db;
 // Vector to hold all imported rows
 vector<RawSteamRow> rawRows;
 
-// Safe string reader to prevent null crashes
-string get_text(sqlite3_stmt* stmt, int col) {
-    const unsigned char* val = sqlite3_column_text(stmt, col);
-    return val ? reinterpret_cast<const char*>(val) : "";
-}
-
 // Function to load all rows from the 'steam_games' table
 bool load_raw_rows() {
     string query = "SELECT * FROM steam_games;";
@@ -73,29 +126,7 @@ bool load_raw_rows() {
     }
 
     while (sqlite3_step(stmt) == SQLITE_ROW) {
-        RawSteamRow row;
-        row.url                      = get_text(stmt, 0);
-        row.types                    = get_text(stmt, 1);
-        row.name                     = get_text(stmt, 2);
-        row.desc_snippet             = get_text(stmt, 3);
-        row.recent_reviews           = get_text(stmt, 4);
-        row.all_reviews              = get_text(stmt, 5);
-        row.release_date             = get_text(stmt, 6);
-        row.developer                = get_text(stmt, 7);
-        row.publisher                = get_text(stmt, 8);
-        row.popular_tags             = get_text(stmt, 9);
-        row.game_details             = get_text(stmt, 10);
-        row.languages                = get_text(stmt, 11);
-        row.achievements             = get_text(stmt, 12);
-        row.genre                    = get_text(stmt, 13);
-        row.game_description         = get_text(stmt, 14);
-        row.mature_content           = get_text(stmt, 15);
-        row.minimum_requirements     = get_text(stmt, 16);
-        row.recommended_requirements = get_text(stmt, 17);
-        row.original_price           = get_text(stmt, 18);
-        row.discount_price           = get_text(stmt, 19);
-
-        rawRows.push_back(row);
+        rawRows.push_back(read_raw_row(stmt));
     }
 
     sqlite3_finalize(stmt);
@@ -103,131 +134,1257 @@ bool load_raw_rows() {
     return true;
 }
 
-// Utility to escape quotes and wrap field in quotes for CSV
-string escape_csv(const string& input) {
-    string output = input;
-    size_t pos = 0;
-    while ((pos = output.find("\"", pos)) != string::npos) {
-        output.insert(pos, "\"");  // Double the quote
-        pos += 2;
+// ===================== Part 2a: Hardware Performance Counters =====================
+// --perf-counters: the per-thread counter groups and perf_read() are in steam_common.h.
+// A pool task adds its own delta to the stage that submitted it, so stages running side
+// by side in the stage graph are still counted apart.
+
+// -- Counters of one stage, fed by its own thread and by every pool task it submits
+struct PerfTotals {
+    std::mutex lock;
+    PerfCounts counts;
+
+    void add(const PerfCounts& c) {
+        std::lock_guard<std::mutex> guard(lock);
+        counts += c;
+    }
+};
+
+thread_local PerfTotals* perf_stage = nullptr;   // stage the calling thread is working for
+
+// -- Run f, returning what it cost in counters on this thread and on the pool
+PerfCounts count_stage(const std::function<void()>& f) {
+    if (!perf_counters_enabled) {
+        f();
+        return PerfCounts();
+    }
+    PerfTotals totals;
+    PerfTotals* outer = perf_stage;
+    perf_stage = &totals;
+    PerfCounts before = perf_read();
+    f();
+    totals.add(perf_read() - before);
+    perf_stage = outer;
+    return totals.counts;
+}
+
+// ===================== Part 2b: Trace Recorder =====================
+// --trace records spans (stages, pool tasks, CSV rendering, disk writes, SQLite reads) and
+// writes them to trace.json as Chrome trace events, which open in chrome://tracing or
+// ui.perfetto.dev. Each thread appends to its own ring of TRACE_RING_SPANS spans and
+// overwrites its oldest spans once the ring is full. Every run_pipeline() starts a fresh
+// trace, so the file shows the last run, like the benchmark summary.
+
+const size_t TRACE_RING_SPANS = 1 << 16;
+
+struct TraceSpan {
+    const char* category;
+    char name[56];   // copied and truncated, so recording never allocates
+    long long start_ns;
+    long long end_ns;
+};
+
+struct TraceRing {
+    std::mutex lock;   // uncontended except while exporting or resetting
+    std::vector<TraceSpan> spans;
+    size_t written = 0;
+    unsigned int tid = 0;
+    std::string thread_name;
+    bool alive = true;
+};
+
+bool trace_enabled = false;   // --trace
+std::mutex trace_registry_lock;
+std::vector<std::shared_ptr<TraceRing>> trace_rings;
+unsigned int trace_next_tid = 0;
+const std::chrono::steady_clock::time_point trace_epoch = std::chrono::steady_clock::now();
+
+long long trace_now_ns() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - trace_epoch).count();
+}
+
+// -- The calling thread's ring, registered on first use and marked dead when the thread exits
+struct TraceThread {
+    std::shared_ptr<TraceRing> ring;
+
+    ~TraceThread() {
+        if (!ring) return;
+        std::lock_guard<std::mutex> guard(ring->lock);
+        ring->alive = false;
+    }
+};
+
+TraceRing& trace_ring() {
+    thread_local TraceThread self;
+    if (!self.ring) {
+        self.ring = std::make_shared<TraceRing>();
+        std::lock_guard<std::mutex> guard(trace_registry_lock);
+        self.ring->tid = trace_next_tid++;
+        trace_rings.push_back(self.ring);
+    }
+    return *self.ring;
+}
+
+void trace_thread_name(const std::string& name) {
+    if (!trace_enabled) return;
+    TraceRing& ring = trace_ring();
+    std::lock_guard<std::mutex> guard(ring.lock);
+    ring.thread_name = name;
+}
+
+// -- Records [construction, destruction) as one span; does nothing unless --trace is on
+struct TraceScope {
+    TraceSpan span;
+    bool active;
+
+    TraceScope(const char* category, std::string_view name) : active(trace_enabled) {
+        if (!active) return;
+        span.category = category;
+        size_t n = std::min(name.size(), sizeof(span.name) - 1);
+        std::memcpy(span.name, name.data(), n);
+        span.name[n] = '\0';
+        span.start_ns = trace_now_ns();
+    }
+
+    ~TraceScope() {
+        if (!active) return;
+        span.end_ns = trace_now_ns();
+        TraceRing& ring = trace_ring();
+        std::lock_guard<std::mutex> guard(ring.lock);
+        if (ring.spans.size() < TRACE_RING_SPANS)
+            ring.spans.push_back(span);
+        else
+            ring.spans[ring.written % TRACE_RING_SPANS] = span;
+        ring.written++;
+    }
+
+    TraceScope(const TraceScope&) = delete;
+    TraceScope& operator=(const TraceScope&) = delete;
+};
+
+// -- Drop every span, and the rings of threads that have exited; call between runs
+void trace_reset() {
+    if (!trace_enabled) return;
+    std::lock_guard<std::mutex> guard(trace_registry_lock);
+    std::vector<std::shared_ptr<TraceRing>> kept;
+    for (auto& ring : trace_rings) {
+        std::lock_guard<std::mutex> ring_guard(ring->lock);
+        if (!ring->alive) continue;
+        ring->spans.clear();
+        ring->written = 0;
+        kept.push_back(ring);
+    }
+    trace_rings.swap(kept);
+}
+
+void append_json_string(std::string& out, const char* text) {
+    out += '"';
+    for (const char* c = text; *c; ++c) {
+        if (*c == '"' || *c == '\\') out += '\\';
+        out += static_cast<unsigned char>(*c) < 0x20 ? ' ' : *c;
+    }
+    out += '"';
+}
+
+// -- Write every ring as complete ("X") events plus one thread_name record per thread
+void export_trace(const std::string& filename = "trace.json") {
+    if (!trace_enabled) return;
+    std::string out = "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+    size_t spans = 0, dropped = 0;
+    char buf[128];
+    {
+        std::lock_guard<std::mutex> guard(trace_registry_lock);
+        for (auto& ring : trace_rings) {
+            std::lock_guard<std::mutex> ring_guard(ring->lock);
+            if (ring->spans.empty()) continue;
+            std::string name = ring->thread_name.empty() ? "thread " + std::to_string(ring->tid) : ring->thread_name;
+            std::snprintf(buf, sizeof(buf), "{\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"name\":\"thread_name\",\"args\":{\"name\":", ring->tid);
+            out += buf;
+            append_json_string(out, name.c_str());
+            out += "}},\n";
+            for (const auto& span : ring->spans) {
+                out += "{\"ph\":\"X\",\"pid\":1,\"tid\":" + std::to_string(ring->tid) + ",\"cat\":";
+                append_json_string(out, span.category);
+                out += ",\"name\":";
+                append_json_string(out, span.name);
+                std::snprintf(buf, sizeof(buf), ",\"ts\":%.3f,\"dur\":%.3f},\n",
+                              span.start_ns / 1e3, (span.end_ns - span.start_ns) / 1e3);
+                out += buf;
+            }
+            spans += ring->spans.size();
+            dropped += ring->written - ring->spans.size();
+        }
+    }
+    if (out.size() > 2 && out[out.size() - 2] == ',') out.erase(out.size() - 2, 1);
+    out += "]}\n";
+
+    std::ofstream file(filename, std::ios::binary);
+    file.write(out.data(), out.size());
+    if (!file) {
+        std::cerr << "❌ Failed to write " << filename << "\n";
+        return;
+    }
+    std::cout << "🧭 Trace with " << spans << " spans (" << dropped << " overwritten) saved to " << filename << "\n";
+}
+
+// ===================== Part 2c: Work-Stealing Thread Pool =====================
+// One process-wide pool, created on first use and kept for the whole sweep. Callers hand
+// run_tasks() a list of small tasks, or use parallel_for() with a grain size, and return
+// once their batch is done; several callers (concurrent stages) can have batches in
+// flight at once. Each worker starts with a contiguous block of a batch in its own deque
+// and pops from the back; once it runs dry it steals from the front of another worker's
+// deque, so a few heavy tasks (a mega-publisher, a batch of long requirement blocks) no
+// longer hold up one static range. The caller does not sleep while it waits: it takes
+// queued tasks of its own batch (never another batch's, so a stage's time only holds its
+// own work) and runs them as one more worker. A task may therefore call run_tasks()
+// itself. Busy/idle time per worker and batch is logged for the benchmark summary.
+
+struct WorkerStats {
+    long long busy_us = 0;   // running this batch's tasks
+    long long idle_us = 0;   // rest of the batch's wall time
+    size_t tasks = 0;
+    size_t steals = 0;
+};
+
+struct SchedulerRun {
+    std::string label;
+    size_t tasks = 0;
+    std::vector<WorkerStats> workers;
+};
+
+std::vector<SchedulerRun> scheduler_log;
+std::mutex scheduler_log_lock;
+
+// -- One run_tasks() call; workers charge their time to the batch of the task they ran
+struct TaskBatch {
+    std::string label;   // span name of its tasks in the trace
+    std::atomic<size_t> remaining{0};
+    size_t submitted = 0;   // tasks added through submit()
+    std::vector<WorkerStats> stats;
+    std::mutex lock;
+    std::condition_variable done;
+};
+
+struct PoolTask {
+    std::function<void()> run;
+    TaskBatch* batch = nullptr;
+    PerfTotals* perf = nullptr;   // stage charged for the task's counters (--perf-counters)
+    unsigned int stage = 0;       // profiler stage id of the submitter (--profile)
+};
+
+struct TaskDeque {
+    std::mutex lock;
+    std::deque<PoolTask> tasks;
+};
+
+thread_local unsigned int current_worker = 0;   // worker slot of this thread; see ThreadPool::slots()
+thread_local bool on_pool_worker = false;       // set for the pool's own threads
+thread_local unsigned int profile_stage = 0;    // stage id SIGPROF samples of this thread go to (Part 2f)
+
+size_t grain_override = 0;   // --grain ROWS; 0 keeps each stage's default
+
+size_t grain_for(size_t stage_default) { return grain_override > 0 ? grain_override : stage_default; }
+
+// -- Default pool size: one worker per --cpus entry, else one per logical processor
+unsigned int worker_count() {
+    if (!cpu_list.empty()) return static_cast<unsigned int>(cpu_list.size());
+    unsigned int threads = std::thread::hardware_concurrency();
+    return threads == 0 ? 4 : threads;
+}
+
+// -- Take the oldest queued task of 'batch' from q, leaving other batches' tasks in place
+bool pop_batch_task(TaskDeque& q, const TaskBatch& batch, PoolTask& task) {
+    std::lock_guard<std::mutex> guard(q.lock);
+    auto it = std::find_if(q.tasks.begin(), q.tasks.end(), [&](const PoolTask& t) { return t.batch == &batch; });
+    if (it == q.tasks.end()) return false;
+    task = std::move(*it);
+    q.tasks.erase(it);
+    return true;
+}
+
+bool pop_task(TaskDeque& q, PoolTask& task, bool from_back) {
+    std::lock_guard<std::mutex> guard(q.lock);
+    if (q.tasks.empty()) return false;
+    if (from_back) {
+        task = std::move(q.tasks.back());
+        q.tasks.pop_back();
+    } else {
+        task = std::move(q.tasks.front());
+        q.tasks.pop_front();
+    }
+    return true;
+}
+
+struct ThreadPool {
+    std::vector<TaskDeque> queues;
+    std::vector<std::thread> threads;
+    std::mutex lock;
+    std::condition_variable wake;
+    std::atomic<size_t> queued{0};   // tasks sitting in any deque
+    bool stopping = false;
+    unsigned int started = 0;        // workers past their pinning attempt
+    unsigned int unpinned = 0;       // of those, workers whose pinning failed
+    std::condition_variable all_started;
+
+    // Worker w pins itself to cpus[w % cpus.size()] before taking tasks; an empty list
+    // leaves placement to the OS. Returns once every worker has tried, so failures are
+    // reported here and no timed task runs on a thread that has not been placed yet.
+    ThreadPool(unsigned int n, const std::vector<int>& cpus) : queues(n) {
+        for (unsigned int w = 0; w < n; ++w) {
+            int cpu = cpus.empty() ? -1 : cpus[w % cpus.size()];
+            threads.emplace_back([this, w, cpu] { worker_loop(w, cpu); });
+        }
+        std::unique_lock<std::mutex> guard(lock);
+        all_started.wait(guard, [&] { return started == n; });
+        if (unpinned > 0) std::cerr << "⚠️  " << unpinned << " of " << n << " workers could not be pinned\n";
+    }
+
+    ~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            stopping = true;
+        }
+        wake.notify_all();
+        for (auto& t : threads) t.join();
+    }
+
+    unsigned int size() const { return static_cast<unsigned int>(queues.size()); }
+
+    // -- Worker slots: 0..size()-1 are the pool's threads, slot size() is a caller running
+    // tasks of its own batch while it waits. Per-worker scratch is indexed by current_worker.
+    unsigned int slots() const { return size() + 1; }
+
+    void worker_loop(unsigned int w, int cpu) {
+        current_worker = w;
+        on_pool_worker = true;
+        trace_thread_name("pool worker " + std::to_string(w));
+        bool pinned = cpu < 0 || pin_current_thread(cpu);
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            started++;
+            if (!pinned) unpinned++;
+        }
+        all_started.notify_one();
+        unsigned int n = size();
+        PoolTask task;
+        while (true) {
+            bool stolen = false;
+            bool found = pop_task(queues[w], task, true);
+            for (unsigned int k = 1; !found && k < n; ++k)
+                found = stolen = pop_task(queues[(w + k) % n], task, false);
+
+            if (!found) {
+                std::unique_lock<std::mutex> guard(lock);
+                wake.wait(guard, [&] { return stopping || queued.load() > 0; });
+                if (stopping) return;
+                continue;
+            }
+            queued--;
+            execute(task, w, stolen);
+        }
+    }
+
+    // -- Run one task on this thread and charge it to its batch's stats slot 'slot'
+    void execute(PoolTask& task, unsigned int slot, bool stolen) {
+        auto t0 = std::chrono::steady_clock::now();
+        // A caller helping with its own batch is already inside its stage's count_stage()
+        bool charge = task.perf && task.perf != perf_stage;
+        PerfCounts before = charge ? perf_read() : PerfCounts();
+        unsigned int outer_stage = profile_stage;
+        profile_stage = task.stage;
+        {
+            TraceScope scope("task", task.batch->label.empty() ? "task" : task.batch->label);
+            task.run();
+        }
+        profile_stage = outer_stage;
+        if (charge) task.perf->add(perf_read() - before);
+        WorkerStats& ws = task.batch->stats[slot];
+        ws.busy_us += std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - t0).count();
+        ws.tasks++;
+        if (stolen) ws.steals++;
+
+        // Decrement under the batch lock so the waiter cannot return (and destroy the
+        // batch) between the count reaching zero and the notify
+        TaskBatch* batch = task.batch;
+        task = PoolTask();
+        std::lock_guard<std::mutex> guard(batch->lock);
+        if (--batch->remaining == 0) batch->done.notify_all();
+    }
+
+    void run(std::vector<std::function<void()>>& tasks, TaskBatch& batch) {
+        unsigned int n = size();
+        batch.stats.assign(slots(), WorkerStats());
+        batch.remaining = tasks.size();
+        for (size_t i = 0; i < tasks.size(); ++i) {
+            TaskDeque& q = queues[i * n / tasks.size()];
+            std::lock_guard<std::mutex> guard(q.lock);
+            q.tasks.push_back({std::move(tasks[i]), &batch, perf_stage, profile_stage});
+        }
+        queued += tasks.size();
+        {
+            std::lock_guard<std::mutex> guard(lock);
+        }
+        wake.notify_all();
+
+        wait(batch);
+    }
+
+    // -- Add one task to a batch that may already be running (a producer feeding the pool
+    // as input arrives); tasks go round-robin over the deques. Finish with wait().
+    void submit(std::function<void()> task, TaskBatch& batch) {
+        unsigned int n = size();
+        if (batch.stats.empty()) batch.stats.assign(slots(), WorkerStats());
+        TaskDeque& q = queues[batch.submitted++ % n];
+        batch.remaining++;
+        {
+            std::lock_guard<std::mutex> guard(q.lock);
+            q.tasks.push_back({std::move(task), &batch, perf_stage, profile_stage});
+        }
+        queued++;
+        {
+            std::lock_guard<std::mutex> guard(lock);
+        }
+        wake.notify_one();
+    }
+
+    // -- Run one queued task of the batch on this thread; false if none is left in a deque.
+    // A pool thread keeps its own slot (it cannot be running another task of this batch
+    // meanwhile); any other thread takes slot size().
+    bool run_one(TaskBatch& batch) {
+        unsigned int n = size();
+        unsigned int slot = on_pool_worker ? current_worker : n;
+        PoolTask task;
+        bool found = false;
+        for (unsigned int k = 0; !found && k < n; ++k)
+            found = pop_batch_task(queues[(slot + k) % n], batch, task);
+        if (!found) return false;
+        queued--;
+        unsigned int outer_worker = current_worker;
+        current_worker = slot;
+        execute(task, slot, true);
+        current_worker = outer_worker;
+        return true;
+    }
+
+    // -- Help with the batch until none of its tasks is left in a deque, then block until
+    // the ones still running elsewhere finish
+    void wait(TaskBatch& batch) {
+        while (batch.remaining.load() > 0 && run_one(batch)) {}
+
+        std::unique_lock<std::mutex> guard(batch.lock);
+        batch.done.wait(guard, [&] { return batch.remaining.load() == 0; });
+    }
+};
+
+std::unique_ptr<ThreadPool>& pool_instance() {
+    static std::unique_ptr<ThreadPool> pool(new ThreadPool(worker_count(), cpu_list));
+    return pool;
+}
+
+ThreadPool& thread_pool() { return *pool_instance(); }
+
+std::mutex pool_swap_lock;   // held while the pool is replaced, so the metrics reporter can read it
+
+// -- Replace the pool with one of 'n' workers (the thread-count axis of the sweep).
+// Only call between runs, never while a stage is using the pool.
+void restart_thread_pool(unsigned int n) {
+    std::lock_guard<std::mutex> guard(pool_swap_lock);
+    auto& pool = pool_instance();
+    pool.reset();
+    pool.reset(new ThreadPool(n, cpu_list));
+}
+
+// -- Record a finished batch; idle time is whatever part of its wall time a worker was not busy
+void log_batch(const std::string& label, size_t tasks, TaskBatch& batch, long long wall_us) {
+    if (label.empty()) return;
+    for (auto& ws : batch.stats) ws.idle_us = std::max(0LL, wall_us - ws.busy_us);
+    std::lock_guard<std::mutex> guard(scheduler_log_lock);
+    scheduler_log.push_back({label, tasks, std::move(batch.stats)});
+}
+
+// -- Run every task once on the pool; returns after all of them have finished.
+// An empty label keeps the run out of scheduler_log.
+void run_tasks(const std::string& label, std::vector<std::function<void()>> tasks) {
+    if (tasks.empty()) return;
+    ThreadPool& pool = thread_pool();
+    TaskBatch batch;
+    batch.label = label;
+    size_t count = tasks.size();
+    auto start = std::chrono::steady_clock::now();
+    pool.run(tasks, batch);
+    long long wall_us = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+    log_batch(label, count, batch, wall_us);
+}
+
+// -- Split [begin, end) into ranges of 'grain' and run body(lo, hi) for each on the pool
+void parallel_for(const std::string& label, size_t begin, size_t end, size_t grain,
+                  const std::function<void(size_t, size_t)>& body) {
+    grain = std::max<size_t>(1, grain);
+    std::vector<std::function<void()>> tasks;
+    for (size_t lo = begin; lo < end; lo += grain) {
+        size_t hi = std::min(end, lo + grain);
+        tasks.push_back([&body, lo, hi] { body(lo, hi); });
     }
-    return "\"" + output + "\"";
+    run_tasks(label, std::move(tasks));
+}
+
+// ===================== Part 2d: Buffered CSV Writer =====================
+// Exports render their rows on the pool: each task formats a contiguous block of rows into
+// its own byte buffer. The finished blocks go to a background I/O thread that writes them
+// in order, one large write per block, while computation carries on; main() waits for the
+// pending writes once, at the end. Fields are escaped straight into the buffer.
+
+// -- Append a number with the same text 'std::ostream << value' produces by default
+template <class T>
+void append_csv_number(std::string& out, T value) {
+    char buf[32];
+    int n;
+    if constexpr (std::is_floating_point_v<T>)
+        n = std::snprintf(buf, sizeof(buf), "%g", static_cast<double>(value));
+    else
+        n = std::snprintf(buf, sizeof(buf), "%lld", static_cast<long long>(value));
+    out.append(buf, n);
+}
+
+// -- One output line: CsvLine(out).field(name).number(price).end();
+struct CsvLine {
+    std::string& out;
+    bool first = true;
+
+    explicit CsvLine(std::string& buffer) : out(buffer) {}
+
+    void separate() {
+        if (!first) out += ',';
+        first = false;
+    }
+    CsvLine& field(std::string_view value) { separate(); append_csv_field(out, value); return *this; }
+    CsvLine& text(std::string_view value)  { separate(); out.append(value.data(), value.size()); return *this; }
+    template <class T>
+    CsvLine& number(T value)               { separate(); append_csv_number(out, value); return *this; }
+    void end() { out += '\n'; }
+};
+
+// -- A rendered file waiting for the I/O thread
+struct OutputJob {
+    std::string filename;
+    std::vector<std::string> blocks;
+};
+
+struct OutputStats {
+    size_t files = 0;
+    size_t bytes = 0;
+    size_t failures = 0;
+    size_t peak_queued = 0;       // files waiting at once
+    long long write_us = 0;       // I/O thread time spent writing
+    long long blocked_us = 0;     // time callers spent waiting for pending writes
+};
+
+// -- Single background writer; jobs are written in submission order, so a file exported
+// twice ends up with the later contents
+struct AsyncOutput {
+    std::mutex lock;
+    std::condition_variable ready;   // queue gained a job, or stopping
+    std::condition_variable idle;    // queue drained and nothing being written
+    std::deque<OutputJob> queue;
+    bool writing = false;
+    bool stopping = false;
+    OutputStats stats;
+    std::thread io;
+
+    AsyncOutput() { io = std::thread([this] { io_loop(); }); }
+
+    ~AsyncOutput() {
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            stopping = true;
+        }
+        ready.notify_all();
+        io.join();
+    }
+
+    void io_loop() {
+        trace_thread_name("csv writer");
+        std::unique_lock<std::mutex> guard(lock);
+        while (true) {
+            ready.wait(guard, [&] { return stopping || !queue.empty(); });
+            if (queue.empty()) return;   // stopping with nothing left to write
+            OutputJob job = std::move(queue.front());
+            queue.pop_front();
+            writing = true;
+            guard.unlock();
+
+            auto t0 = std::chrono::steady_clock::now();
+            size_t bytes = 0;
+            std::ofstream file;
+            {
+                TraceScope scope("io", job.filename);
+                file.open(job.filename);
+                for (const auto& block : job.blocks) {
+                    file.write(block.data(), block.size());
+                    bytes += block.size();
+                }
+                file.close();
+            }
+            bool ok = !file.fail();
+            if (!ok) std::cerr << "❌ Failed to write " << job.filename << "\n";
+            long long us = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - t0).count();
+
+            guard.lock();
+            writing = false;
+            stats.files++;
+            stats.bytes += ok ? bytes : 0;
+            stats.failures += ok ? 0 : 1;
+            stats.write_us += us;
+            if (queue.empty()) idle.notify_all();
+        }
+    }
+
+    void submit(OutputJob job) {
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            queue.push_back(std::move(job));
+            stats.peak_queued = std::max(stats.peak_queued, queue.size());
+        }
+        ready.notify_one();
+    }
+
+    // -- Block until every submitted file is on disk
+    void drain() {
+        TraceScope scope("io", "wait for pending writes");
+        auto t0 = std::chrono::steady_clock::now();
+        std::unique_lock<std::mutex> guard(lock);
+        idle.wait(guard, [&] { return queue.empty() && !writing; });
+        stats.blocked_us += std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - t0).count();
+    }
+
+    OutputStats snapshot() {
+        std::lock_guard<std::mutex> guard(lock);
+        return stats;
+    }
+
+    // -- Files queued or being written right now
+    size_t pending() {
+        std::lock_guard<std::mutex> guard(lock);
+        return queue.size() + (writing ? 1 : 0);
+    }
+};
+
+AsyncOutput& async_output() {
+    static AsyncOutput output;
+    return output;
+}
+
+const size_t CSV_GRAIN = 2048;
+
+// -- Render 'header', then format_row(out, i) for i in [0, rows) in row order, and queue
+// the file for the I/O thread. Tables that fit in one block are formatted on the calling thread.
+template <class RowFn>
+void write_csv(const std::string& filename, const std::string& header, size_t rows, RowFn format_row) {
+    size_t grain = grain_for(CSV_GRAIN);
+    size_t blocks = (rows + grain - 1) / grain;
+    std::vector<std::string> buffers(1 + std::max<size_t>(blocks, 1));
+    buffers[0] = header;
+    auto format_block = [&](size_t lo, size_t hi) {
+        TraceScope scope("export", filename);
+        std::string& out = buffers[1 + lo / grain];
+        for (size_t i = lo; i < hi; ++i) format_row(out, i);
+    };
+    if (blocks > 1)
+        parallel_for("", 0, rows, grain, format_block);
+    else
+        format_block(0, rows);
+
+    async_output().submit({filename, std::move(buffers)});
 }
 
 // Debugging export to verify raw data
 void export_raw_debug() {
-    ofstream file("debug_raw_rows.csv");
-    file << "url,types,name,desc_snippet,recent_reviews,all_reviews,release_date,developer,publisher,"
-         << "popular_tags,game_details,languages,achievements,genre,game_description,mature_content,"
-         << "minimum_requirements,recommended_requirements,original_price,discount_price\n";
-
-    for (const auto& row : rawRows) {
-        file << escape_csv(row.url) << ","
-             << escape_csv(row.types) << ","
-             << escape_csv(row.name) << ","
-             << escape_csv(row.desc_snippet) << ","
-             << escape_csv(row.recent_reviews) << ","
-             << escape_csv(row.all_reviews) << ","
-             << escape_csv(row.release_date) << ","
-             << escape_csv(row.developer) << ","
-             << escape_csv(row.publisher) << ","
-             << escape_csv(row.popular_tags) << ","
-             << escape_csv(row.game_details) << ","
-             << escape_csv(row.languages) << ","
-             << escape_csv(row.achievements) << ","
-             << escape_csv(row.genre) << ","
-             << escape_csv(row.game_description) << ","
-             << escape_csv(row.mature_content) << ","
-             << escape_csv(row.minimum_requirements) << ","
-             << escape_csv(row.recommended_requirements) << ","
-             << escape_csv(row.original_price) << ","
-             << escape_csv(row.discount_price) << "\n";
-    }
+    std::string header =
+        "url,types,name,desc_snippet,recent_reviews,all_reviews,release_date,developer,publisher,"
+        "popular_tags,game_details,languages,achievements,genre,game_description,mature_content,"
+        "minimum_requirements,recommended_requirements,original_price,discount_price\n";
 
-    file.close();
+    write_csv("debug_raw_rows.csv", header, rawRows.size(), [](std::string& out, size_t i) {
+        const auto& row = rawRows[i];
+        CsvLine(out)
+            .field(row.url)
+            .field(row.types)
+            .field(row.name)
+            .field(row.desc_snippet)
+            .field(row.recent_reviews)
+            .field(row.all_reviews)
+            .field(row.release_date)
+            .field(row.developer)
+            .field(row.publisher)
+            .field(row.popular_tags)
+            .field(row.game_details)
+            .field(row.languages)
+            .field(row.achievements)
+            .field(row.genre)
+            .field(row.game_description)
+            .field(row.mature_content)
+            .field(row.minimum_requirements)
+            .field(row.recommended_requirements)
+            .field(row.original_price)
+            .field(row.discount_price)
+            .end();
+    });
     cout << "📁 Raw row export saved to debug_raw_rows.csv\n";
 }
-// ===================== Part 3: Format Raw Rows into Structured Games =====================
 
-struct SteamGame {
-    std::string url;
-    std::string types;
+// ===================== Part 2e: Live Metrics =====================
+// --metrics-file PATH keeps a Prometheus text-format snapshot of a running sweep on disk,
+// rewritten every --metrics-interval ms by a background thread (written to PATH.tmp and
+// renamed over PATH, so readers never see half a file; node_exporter's textfile collector
+// or a plain 'watch cat PATH' can follow it). Rows are counted where they are read and
+// parsed, stages report in from the same wrappers that time them for benchmark_log, and
+// queue depths are sampled from the pool, the CSV writer and the pipelined ring. Row and
+// stage counters are totals for the process; stage progress restarts with every run.
+
+std::string metrics_path;               // --metrics-file PATH; empty = no metrics
+long long metrics_interval_ms = 1000;   // --metrics-interval MS
+
+struct StageMetrics {
+    bool running = false;
+    size_t runs = 0;          // finished runs of the stage
+    long long last_ns = 0;    // duration of the latest one
+    long long total_ns = 0;
+};
+
+struct LiveMetrics {
+    std::atomic<uint64_t> rows_ingested{0};   // read from SQLite
+    std::atomic<uint64_t> rows_parsed{0};     // through parse_chunk
+    std::atomic<size_t> ring_depth{0};        // pipelined batches waiting to be parsed
+    std::atomic<uint64_t> runs_started{0};
+    std::atomic<int> run_limit{0};
+    std::atomic<unsigned int> run_threads{0};
+
+    std::mutex lock;   // guards the stage fields below
+    std::map<std::string, StageMetrics> stages;
+    size_t stages_planned = 0;   // in the current run
+    size_t stages_done = 0;
+};
+
+LiveMetrics live_metrics;
+
+// -- A new run of 'planned' stages at 'limit' rows starts
+void metrics_run_begin(int limit, unsigned int threads, size_t planned) {
+    live_metrics.runs_started++;
+    live_metrics.run_limit = limit;
+    live_metrics.run_threads = threads;
+    std::lock_guard<std::mutex> guard(live_metrics.lock);
+    live_metrics.stages_planned = planned;
+    live_metrics.stages_done = 0;
+}
+
+void metrics_stage_begin(const std::string& stage) {
+    std::lock_guard<std::mutex> guard(live_metrics.lock);
+    live_metrics.stages[stage].running = true;
+}
+
+void metrics_stage_end(const std::string& stage, long long ns) {
+    std::lock_guard<std::mutex> guard(live_metrics.lock);
+    StageMetrics& m = live_metrics.stages[stage];
+    m.running = false;
+    m.runs++;
+    m.last_ns = ns;
+    m.total_ns += ns;
+    live_metrics.stages_done++;
+}
+
+// -- Resident set size in bytes; 0 where it is not available (Windows builds do not link psapi)
+uint64_t resident_bytes() {
+#ifdef __linux__
+    std::ifstream statm("/proc/self/statm");
+    uint64_t pages = 0, resident = 0;
+    if (statm >> pages >> resident) return resident * static_cast<uint64_t>(sysconf(_SC_PAGESIZE));
+#endif
+    return 0;
+}
+
+// -- Background writer of the metrics file; a final snapshot is written when it stops
+struct MetricsReporter {
+    std::mutex lock;
+    std::condition_variable wake;
+    bool stopping = false;
+    std::thread thread;
+    std::chrono::steady_clock::time_point started = std::chrono::steady_clock::now();
+    std::chrono::steady_clock::time_point last_at = started;
+    uint64_t last_ingested = 0, last_parsed = 0;
+
+    MetricsReporter() {
+        if (metrics_path.empty()) return;
+        thread = std::thread([this] {
+            trace_thread_name("metrics");
+            std::unique_lock<std::mutex> guard(lock);
+            while (!stopping) {
+                wake.wait_for(guard, std::chrono::milliseconds(metrics_interval_ms));
+                write();
+            }
+        });
+        std::cout << "📈 Live metrics every " << metrics_interval_ms << " ms in " << metrics_path << "\n";
+    }
+
+    ~MetricsReporter() {
+        if (!thread.joinable()) return;
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            stopping = true;
+        }
+        wake.notify_one();
+        thread.join();
+    }
+
+    void write() {
+        auto now = std::chrono::steady_clock::now();
+        double seconds = std::chrono::duration<double>(now - last_at).count();
+        uint64_t ingested = live_metrics.rows_ingested.load(), parsed = live_metrics.rows_parsed.load();
+        size_t pool_queued = 0;
+        {
+            std::lock_guard<std::mutex> guard(pool_swap_lock);
+            pool_queued = thread_pool().queued.load();
+        }
+
+        std::ostringstream out;
+        auto metric = [&](const char* name, const char* type, const char* help, auto value) {
+            out << "# HELP " << name << " " << help << "\n# TYPE " << name << " " << type << "\n"
+                << name << " " << value << "\n";
+        };
+        metric("steam_uptime_seconds", "gauge", "Seconds since the sweep started.",
+               std::chrono::duration<double>(now - started).count());
+        metric("steam_rows_ingested_total", "counter", "Rows read from SQLite.", ingested);
+        metric("steam_rows_parsed_total", "counter", "Rows run through parse_chunk.", parsed);
+        metric("steam_rows_ingested_per_second", "gauge", "Ingest rate since the previous snapshot.",
+               seconds > 0 ? (ingested - last_ingested) / seconds : 0.0);
+        metric("steam_rows_parsed_per_second", "gauge", "Parse rate since the previous snapshot.",
+               seconds > 0 ? (parsed - last_parsed) / seconds : 0.0);
+        metric("steam_runs_started_total", "counter", "Pipeline runs started (warmup included).",
+               live_metrics.runs_started.load());
+        metric("steam_run_limit_rows", "gauge", "Row limit of the current run.", live_metrics.run_limit.load());
+        metric("steam_run_threads", "gauge", "Worker threads of the current run.", live_metrics.run_threads.load());
+        metric("steam_pool_queued_tasks", "gauge", "Tasks waiting in the thread pool deques.", pool_queued);
+        metric("steam_output_queued_files", "gauge", "CSV files queued for or being written by the I/O thread.",
+               async_output().pending());
+        metric("steam_pipeline_ring_depth", "gauge", "Pipelined batches read but not yet handed to the pool.",
+               live_metrics.ring_depth.load());
+        if (uint64_t rss = resident_bytes())
+            metric("steam_resident_memory_bytes", "gauge", "Resident set size of the process.", rss);
+        {
+            std::lock_guard<std::mutex> guard(live_metrics.lock);
+            metric("steam_stages_planned", "gauge", "Stages in the current run.", live_metrics.stages_planned);
+            metric("steam_stages_completed", "gauge", "Stages of the current run that have finished.",
+                   live_metrics.stages_done);
+            out << "# HELP steam_stage_running 1 while the stage is running.\n# TYPE steam_stage_running gauge\n";
+            for (const auto& [stage, m] : live_metrics.stages)
+                out << "steam_stage_running{stage=\"" << stage << "\"} " << (m.running ? 1 : 0) << "\n";
+            out << "# HELP steam_stage_runs_total Finished runs of the stage.\n# TYPE steam_stage_runs_total counter\n";
+            for (const auto& [stage, m] : live_metrics.stages)
+                out << "steam_stage_runs_total{stage=\"" << stage << "\"} " << m.runs << "\n";
+            out << "# HELP steam_stage_last_seconds Duration of the latest finished run of the stage.\n"
+                << "# TYPE steam_stage_last_seconds gauge\n";
+            for (const auto& [stage, m] : live_metrics.stages)
+                out << "steam_stage_last_seconds{stage=\"" << stage << "\"} " << m.last_ns / 1e9 << "\n";
+            out << "# HELP steam_stage_seconds_total Time spent in the stage over all runs.\n"
+                << "# TYPE steam_stage_seconds_total counter\n";
+            for (const auto& [stage, m] : live_metrics.stages)
+                out << "steam_stage_seconds_total{stage=\"" << stage << "\"} " << m.total_ns / 1e9 << "\n";
+        }
+        last_at = now;
+        last_ingested = ingested;
+        last_parsed = parsed;
+
+        // Replace the file in one step so a scraper never reads a partial snapshot
+        std::string tmp = metrics_path + ".tmp";
+        {
+            std::ofstream file(tmp, std::ios::binary | std::ios::trunc);
+            file << out.str();
+            if (!file) return;
+        }
+        std::error_code ec;
+        std::filesystem::rename(tmp, metrics_path, ec);
+    }
+};
+
+// ===================== Part 2f: Sampling Profiler =====================
+// --profile PATH samples the process on SIGPROF (setitimer ITIMER_PROF, --profile-hz times a
+// second of CPU time, so a sample lands on whichever thread is burning CPU). The handler
+// takes the interrupted thread's stack with backtrace() and counts it, together with the
+// stage that thread is working for, in a fixed-size lock-free hash table: no allocation and
+// no locks in the handler. Pool tasks carry their submitter's stage like --perf-counters
+// does. At exit every distinct frame is named once (addr2line for this executable, which
+// also gives source lines when built with -g; backtrace_symbols for shared libraries) and
+// the stacks are written as "stage;outer;...;leaf count" lines for flamegraph.pl or
+// speedscope, plus profile_hot_paths.csv with the hottest source lines of every stage.
+// Linux only; elsewhere the flag is ignored.
+
+std::string profile_path;   // --profile PATH; empty = no sampling
+int profile_hz = 997;       // --profile-hz; prime, so sampling does not beat with periodic work
+
+// -- Stage names by id; samples store the id since stage names do not outlive their run
+std::vector<std::string> profile_stage_names = {"(no stage)"};
+std::mutex profile_stage_lock;
+
+unsigned int profile_stage_id(const std::string& stage) {
+    std::lock_guard<std::mutex> guard(profile_stage_lock);
+    auto it = std::find(profile_stage_names.begin(), profile_stage_names.end(), stage);
+    if (it != profile_stage_names.end()) return static_cast<unsigned int>(it - profile_stage_names.begin());
+    profile_stage_names.push_back(stage);
+    return static_cast<unsigned int>(profile_stage_names.size() - 1);
+}
+
+// -- Samples taken on this thread (and by the pool tasks it submits) go to 'stage'
+struct ProfileStageScope {
+    unsigned int outer;
+
+    explicit ProfileStageScope(const std::string& stage) : outer(profile_stage) {
+        if (!profile_path.empty()) profile_stage = profile_stage_id(stage);
+    }
+    ~ProfileStageScope() { profile_stage = outer; }
+};
+
+#ifdef __linux__
+const int PROFILE_SKIP = 2;         // the handler and the signal trampoline
+const int PROFILE_MAX_FRAMES = 64;
+const size_t PROFILE_SLOTS = 1 << 14;
+
+// -- One distinct (stage, stack); 'key' is claimed with a CAS before the frames are filled in
+struct ProfileSlot {
+    std::atomic<uint64_t> key{0};
+    std::atomic<uint64_t> count{0};
+    unsigned int stage = 0;
+    int depth = 0;
+    void* frames[PROFILE_MAX_FRAMES];   // leaf first
+};
+
+std::unique_ptr<ProfileSlot[]> profile_slots;
+std::atomic<uint64_t> profile_samples{0};
+std::atomic<uint64_t> profile_dropped{0};   // table full
+std::atomic<int> profile_in_handler{0};
+
+void profile_on_sigprof(int) {
+    profile_in_handler++;
+    int saved_errno = errno;
+    void* frames[PROFILE_SKIP + PROFILE_MAX_FRAMES];
+    int depth = backtrace(frames, PROFILE_SKIP + PROFILE_MAX_FRAMES) - PROFILE_SKIP;
+    if (depth > 0) {
+        unsigned int stage = profile_stage;
+        uint64_t key = 1469598103934665603ULL ^ stage;   // FNV-1a over stage and frames
+        for (int i = 0; i < depth; ++i)
+            key = (key ^ reinterpret_cast<uintptr_t>(frames[PROFILE_SKIP + i])) * 1099511628211ULL;
+        key |= 1;   // 0 marks a free slot
+
+        bool counted = false;
+        for (size_t probe = 0; probe < PROFILE_SLOTS && !counted; ++probe) {
+            ProfileSlot& slot = profile_slots[(key + probe) & (PROFILE_SLOTS - 1)];
+            uint64_t seen = slot.key.load(std::memory_order_acquire);
+            if (seen == 0 && slot.key.compare_exchange_strong(seen, key, std::memory_order_acq_rel)) {
+                slot.stage = stage;
+                slot.depth = depth;
+                for (int i = 0; i < depth; ++i) slot.frames[i] = frames[PROFILE_SKIP + i];
+                seen = key;
+            }
+            if (seen == key) {
+                slot.count.fetch_add(1, std::memory_order_relaxed);
+                counted = true;
+            }
+        }
+        if (!counted) profile_dropped++;
+        profile_samples++;
+    }
+    errno = saved_errno;
+    profile_in_handler--;
+}
+
+bool start_profiler() {
+    void* warm[4];
+    backtrace(warm, 4);   // the first call loads the unwinder, which must not happen in the handler
+    profile_slots.reset(new ProfileSlot[PROFILE_SLOTS]);
+
+    struct sigaction action = {};
+    action.sa_handler = profile_on_sigprof;
+    action.sa_flags = SA_RESTART;
+    sigemptyset(&action.sa_mask);
+    if (sigaction(SIGPROF, &action, nullptr) != 0) return false;
+
+    itimerval timer = {};
+    timer.it_interval.tv_usec = std::max(1, 1000000 / std::max(1, profile_hz));
+    timer.it_value = timer.it_interval;
+    return setitimer(ITIMER_PROF, &timer, nullptr) == 0;
+}
+
+void stop_profiler() {
+    itimerval off = {};
+    setitimer(ITIMER_PROF, &off, nullptr);
+    signal(SIGPROF, SIG_IGN);
+    while (profile_in_handler.load() > 0) std::this_thread::yield();
+}
+
+// -- A loaded object: the executable (first) or a shared library
+struct LoadedModule {
     std::string name;
-    std::string desc_snippet;
-    std::string recent_reviews;
-    std::string all_reviews;
-    std::string release_date;
-    std::string developer;
-    std::string publisher;
-    std::string popular_tags;
-    std::string game_details;
-    std::string languages;
-    std::string achievements;
-    std::string genre;
-    std::string game_description;
-    std::string mature_content;
-    std::string minimum_requirements;
-    std::string recommended_requirements;
-    float original_price = -1.0f;
-    float discount_price = -1.0f;
-    float all_reviews_percent = -1.0f;
-    float recent_reviews_percent = -1.0f;
-    std::string overall_genre;
+    uintptr_t base = 0, lo = UINTPTR_MAX, hi = 0;
 };
 
-std::vector<SteamGame> structured_games;
+std::vector<LoadedModule> loaded_modules() {
+    std::vector<LoadedModule> modules;
+    dl_iterate_phdr([](dl_phdr_info* info, size_t, void* data) {
+        LoadedModule m;
+        m.name = info->dlpi_name && *info->dlpi_name ? info->dlpi_name : "";
+        m.base = info->dlpi_addr;
+        for (int i = 0; i < info->dlpi_phnum; ++i) {
+            if (info->dlpi_phdr[i].p_type != PT_LOAD) continue;
+            uintptr_t start = info->dlpi_addr + info->dlpi_phdr[i].p_vaddr;
+            m.lo = std::min(m.lo, start);
+            m.hi = std::max(m.hi, start + info->dlpi_phdr[i].p_memsz);
+        }
+        static_cast<std::vector<LoadedModule>*>(data)->push_back(m);
+        return 0;
+    }, &modules);
+    return modules;
+}
 
-// -- Extract rating percent (e.g., from "Very Positive (95%)")
-float extract_review_percent(const std::string& input) {
-    size_t percent_pos = input.rfind('%');
-    if (percent_pos == std::string::npos) return -1.0f;
-    size_t start = input.rfind('(', percent_pos);
-    if (start == std::string::npos) return -1.0f;
-    try {
-        return std::stof(input.substr(start + 1, percent_pos - start - 1));
-    } catch (...) {
-        return -1.0f;
+// -- "ns::f<T>(int)::{lambda(int)#1}::operator()(int) const" -> "ns::f::{lambda#1}::operator()";
+// argument and template lists make flame graph frames unreadable and the line says the rest
+std::string compact_frame_name(const std::string& name) {
+    std::string out;
+    int depth = 0;
+    for (size_t i = 0; i < name.size(); ++i) {
+        if (depth == 0 && name.compare(i, 8, "operator") == 0) {
+            size_t j = i + 8;
+            if (name.compare(j, 2, "()") == 0) j += 2;
+            else while (j < name.size() && std::strchr("<>=!+-*/%&|^~[],", name[j])) j++;
+            out.append(name, i, j - i);
+            i = j - 1;
+            continue;
+        }
+        char c = name[i];
+        if (c == '<' || c == '(') depth++;
+        else if (c == '>' || c == ')') depth = std::max(0, depth - 1);
+        else if (depth == 0) out += c;
     }
+    if (out.size() > 6 && out.compare(out.size() - 6, 6, " const") == 0) out.resize(out.size() - 6);
+    return out;
 }
 
-// -- Parse price field, set "free" to 0
-float parse_price(const std::string& price) {
-    std::string lower = price;
-    std::transform(lower.begin(), lower.end(), lower.begin(), ::tolower);
-    if (lower.find("free") != std::string::npos) return 0.0f;
-    try {
-        return std::stof(lower);
-    } catch (...) {
-        return -1.0f;
+struct FrameName {
+    std::string function;
+    std::string location;   // file:line, or module+0xoffset when there is no line info
+};
+
+// -- Start args[0] (looked up on PATH) with its stdout on a pipe and stderr on /dev/null.
+// The arguments go to the child as an argv array, never through a shell, so a path with
+// quotes or spaces in it is passed as is. Returns the read end, or nullptr if the child
+// could not be started; fclose() it, then waitpid() the child.
+FILE* spawn_reader(const std::vector<std::string>& args, pid_t& pid) {
+    int fds[2];
+    if (pipe2(fds, O_CLOEXEC) != 0) return nullptr;
+    std::vector<char*> argv;
+    for (const auto& arg : args) argv.push_back(const_cast<char*>(arg.c_str()));
+    argv.push_back(nullptr);
+
+    posix_spawn_file_actions_t actions;
+    posix_spawn_file_actions_init(&actions);
+    posix_spawn_file_actions_adddup2(&actions, fds[1], STDOUT_FILENO);
+    posix_spawn_file_actions_addopen(&actions, STDERR_FILENO, "/dev/null", O_WRONLY, 0);
+    int rc = posix_spawnp(&pid, argv[0], &actions, nullptr, argv.data(), environ);
+    posix_spawn_file_actions_destroy(&actions);
+    close(fds[1]);
+    if (rc != 0) {
+        close(fds[0]);
+        return nullptr;
+    }
+    FILE* out = fdopen(fds[0], "r");
+    if (!out) {
+        close(fds[0]);
+        waitpid(pid, nullptr, 0);
     }
+    return out;
 }
 
-// -- Merge genre tags from 3 sources into deduplicated string
-std::string merge_genres(const std::string& tags, const std::string& details, const std::string& genre) {
-    std::set<std::string> all;
-    std::stringstream ss(tags + "," + details + "," + genre);
-    std::string token;
-    while (std::getline(ss, token, ',')) {
-        std::string trimmed;
-        std::remove_copy_if(token.begin(), token.end(), std::back_inserter(trimmed), ::isspace);
-        if (!trimmed.empty()) all.insert(trimmed);
+// -- Name every distinct frame address once. An address of this executable can stand for
+// several frames (functions inlined into each other); they come innermost first.
+std::map<uintptr_t, std::vector<FrameName>> symbolize(const std::set<uintptr_t>& addresses) {
+    std::map<uintptr_t, std::vector<FrameName>> names;
+    std::vector<LoadedModule> modules = loaded_modules();
+    auto module_of = [&](uintptr_t a) -> const LoadedModule* {
+        for (const auto& m : modules)
+            if (a >= m.lo && a < m.hi) return &m;
+        return nullptr;
+    };
+    char exe[4096];
+    ssize_t len = readlink("/proc/self/exe", exe, sizeof(exe) - 1);
+    exe[len > 0 ? len : 0] = '\0';
+
+    // This executable: addr2line reads .symtab (static functions too), the line table and
+    // the inline chains; -a starts every address's answer with the address itself
+    std::vector<uintptr_t> own;
+    for (uintptr_t a : addresses)
+        if (!modules.empty() && module_of(a) == &modules[0]) own.push_back(a);
+    for (size_t at = 0; at < own.size() && len > 0; at += 256) {
+        std::vector<std::string> args = {"addr2line", "-a", "-i", "-C", "-f", "-e", exe};
+        size_t end = std::min(own.size(), at + 256);
+        for (size_t i = at; i < end; ++i) {
+            std::ostringstream offset;
+            offset << "0x" << std::hex << own[i] - modules[0].base;
+            args.push_back(offset.str());
+        }
+        pid_t child;
+        FILE* out = spawn_reader(args, child);
+        if (!out) break;
+        char line[8192];
+        size_t i = at - 1;
+        while (fgets(line, sizeof(line), out)) {
+            std::string function(line, std::strcspn(line, "\n"));
+            if (function.rfind("0x", 0) == 0) {
+                ++i;
+                continue;
+            }
+            FrameName name{compact_frame_name(function), ""};
+            if (fgets(line, sizeof(line), out)) name.location = std::string(line, std::strcspn(line, "\n"));
+            size_t discriminator = name.location.find(" (discriminator");
+            if (discriminator != std::string::npos) name.location.resize(discriminator);
+            if (name.location.rfind("??", 0) == 0) name.location.clear();
+            if (i < end && function != "??") names[own[i]].push_back(name);
+        }
+        fclose(out);
+        waitpid(child, nullptr, 0);
     }
 
-    std::string result;
-    for (const auto& g : all) {
-        if (!result.empty()) result += ", ";
-        result += g;
+    // Shared libraries, and whatever addr2line could not name: dynamic symbols only
+    for (uintptr_t a : addresses) {
+        const LoadedModule* m = module_of(a);
+        std::string module = m ? (m->name.empty() ? std::string(exe) : m->name) : "?";
+        module = module.substr(module.rfind('/') + 1);
+        std::ostringstream where;
+        where << module << "+0x" << std::hex << a - (m ? m->base : 0);
+
+        std::vector<FrameName>& chain = names[a];
+        for (auto& name : chain)
+            if (name.location.empty()) name.location = where.str();
+        if (!chain.empty()) continue;
+
+        // "module(symbol+0xoff) [0xaddr]"
+        void* pc = reinterpret_cast<void*>(a);
+        char** symbols = backtrace_symbols(&pc, 1);
+        std::string text = symbols ? symbols[0] : "";
+        std::free(symbols);
+        size_t open = text.find('('), plus = text.find('+', open);
+        std::string symbol = open != std::string::npos && plus != std::string::npos
+                           ? text.substr(open + 1, plus - open - 1) : "";
+        if (symbol.empty()) {
+            chain.push_back({"[" + where.str() + "]", where.str()});
+            continue;
+        }
+        int status = 0;
+        char* demangled = abi::__cxa_demangle(symbol.c_str(), nullptr, nullptr, &status);
+        chain.push_back({compact_frame_name(status == 0 ? demangled : symbol), where.str()});
+        std::free(demangled);
     }
-    return result;
+    return names;
 }
 
-// -- Thread worker to parse a chunk of raw rows
-void parse_chunk(int start, int end, std::vector<SteamGame>& local) {
-    for (int i = start; i < end; ++i) {
-        const auto& row = rawRows[i];
+// -- A line of this program's own source (not a system header or a library)
+bool own_source_line(const FrameName& frame) {
+    return frame.location.find(':') != std::string::npos && frame.location.rfind("/usr/", 0) != 0;
+}
+
+// -- Write the folded stacks and the per-stage hot-line table. Each sample counts towards
+// the innermost line of this program on its stack, so time spent in the standard library
+// or SQLite is charged to the line that called it.
+void export_profile() {
+    stop_profiler();
+    struct Stack { unsigned int stage; std::vector<uintptr_t> frames; uint64_t count; };
+    std::vector<Stack> stacks;
+    std::set<uintptr_t> addresses;
+    for (size_t i = 0; i < PROFILE_SLOTS; ++i) {
+        const ProfileSlot& slot = profile_slots[i];
+        uint64_t count = slot.count.load();
+        if (slot.key.load() == 0 || count == 0) continue;
+        Stack stack{slot.stage, {}, count};
+        for (int f = 0; f < slot.depth; ++f) {
+            // Callers' frames hold return addresses; step back into the call instruction
+            uintptr_t a = reinterpret_cast<uintptr_t>(slot.frames[f]) - (f > 0 ? 1 : 0);
+            stack.frames.push_back(a);
+            addresses.insert(a);
+        }
+        stacks.push_back(std::move(stack));
+    }
+    std::map<uintptr_t, std::vector<FrameName>> names = symbolize(addresses);
+
+    // Identical names (different addresses in one function) fold into one line
+    std::map<std::string, uint64_t> folded;
+    std::map<std::tuple<unsigned int, std::string, std::string>, uint64_t> hot;   // (stage, function, line)
+    std::vector<uint64_t> stage_total(profile_stage_names.size(), 0);
+    for (const auto& stack : stacks) {
+        std::string line = profile_stage_names[stack.stage];
+        for (auto it = stack.frames.rbegin(); it != stack.frames.rend(); ++it) {
+            const auto& chain = names[*it];
+            for (auto frame = chain.rbegin(); frame != chain.rend(); ++frame) line += ";" + frame->function;
+        }
+        folded[line] += stack.count;
+
+        const FrameName* charged = &names[stack.frames.front()].front();
+        bool found = false;
+        for (size_t f = 0; f < stack.frames.size() && !found; ++f)
+            for (const auto& frame : names[stack.frames[f]])
+                if (own_source_line(frame)) {
+                    charged = &frame;
+                    found = true;
+                    break;
+                }
+        hot[{stack.stage, charged->function, charged->location}] += stack.count;
+        stage_total[stack.stage] += stack.count;
+    }
+
+    std::ofstream out(profile_path);
+    for (const auto& [line, count] : folded) out << line << " " << count << "\n";
+    std::cout << "🔥 " << profile_samples.load() << " samples (" << profile_dropped.load()
+              << " dropped) in " << folded.size() << " stacks saved to " << profile_path << "\n";
+
+    // Hottest 20 lines of every stage
+    std::vector<std::pair<uint64_t, std::tuple<unsigned int, std::string, std::string>>> rows;
+    for (const auto& [key, count] : hot) rows.push_back({count, key});
+    std::sort(rows.begin(), rows.end(), [](const auto& a, const auto& b) {
+        if (std::get<0>(a.second) != std::get<0>(b.second)) return std::get<0>(a.second) < std::get<0>(b.second);
+        return a.first > b.first;
+    });
+    std::string csv = "Stage,Function,Source,Samples,Stage Share\n";
+    unsigned int last_stage = UINT_MAX;
+    int shown = 0;
+    for (const auto& [count, key] : rows) {
+        const auto& [stage, function, location] = key;
+        shown = stage == last_stage ? shown + 1 : 0;
+        last_stage = stage;
+        if (shown >= 20) continue;
+        CsvLine(csv)
+            .field(profile_stage_names[stage])
+            .field(function)
+            .field(location)
+            .number(count)
+            .number(static_cast<double>(count) / stage_total[stage])
+            .end();
+    }
+    std::ofstream("profile_hot_paths.csv") << csv;
+    std::cout << "📄 Hottest lines per stage saved to profile_hot_paths.csv\n";
+}
+#else
+bool start_profiler() { return false; }
+void export_profile() {}
+#endif
+
+// ===================== Part 3: Format Raw Rows into Structured Games =====================
+
+StringPool tag_dict;
+std::vector<std::vector<uint32_t>> tag_tokens;        // string_pool id -> tag_dict ids
+
+// -- Thread worker to parse a chunk of raw rows (interns into the thread's own pools)
+void parse_chunk(const std::vector<RawSteamRow>& rows, size_t start, size_t end,
+                 std::vector<SteamGame>& local, StringPool& pool, StringPool& genres) {
+    for (size_t i = start; i < end; ++i) {
+        const auto& row = rows[i];
 
         float original = parse_price(row.original_price);
-        if (original < 0 || row.name.empty()) continue;
+        if (std::isnan(original)) continue;
 
         SteamGame game;
         game.url                      = row.url;
@@ -237,11 +1394,11 @@ void parse_chunk(int start, int end, std::vector<SteamGame>& local) {
         game.recent_reviews           = row.recent_reviews;
         game.all_reviews              = row.all_reviews;
         game.release_date             = row.release_date;
-        game.developer                = row.developer;
-        game.publisher                = row.publisher;
-        game.popular_tags             = row.popular_tags;
+        game.developer.id             = pool.intern(row.developer);
+        game.publisher.id             = pool.intern(row.publisher);
+        game.popular_tags.id          = pool.intern(row.popular_tags);
         game.game_details             = row.game_details;
-        game.languages                = row.languages;
+        game.languages.id             = pool.intern(row.languages);
         game.achievements             = row.achievements;
         game.genre                    = row.genre;
         game.game_description         = row.game_description;
@@ -249,505 +1406,1426 @@ void parse_chunk(int start, int end, std::vector<SteamGame>& local) {
         game.minimum_requirements     = row.minimum_requirements;
         game.recommended_requirements = row.recommended_requirements;
         game.original_price           = original;
-        game.discount_price           = parse_price(row.discount_price);
+        float discount                = parse_price(row.discount_price);
+        game.discount_price           = std::isnan(discount) ? -1.0f : discount;
         game.all_reviews_percent      = extract_review_percent(row.all_reviews);
         game.recent_reviews_percent   = extract_review_percent(row.recent_reviews);
-        game.overall_genre            = merge_genres(row.popular_tags, row.game_details, row.genre);
+
+        std::set<std::string> tokens = genre_tokens(row.popular_tags, row.game_details, row.genre);
+        game.overall_genre            = join_genres(tokens);
+        for (const auto& token : tokens)
+            game.genre_ids.push_back(genres.intern(token));
 
         local.push_back(game);
     }
+    live_metrics.rows_parsed.fetch_add(end - start, std::memory_order_relaxed);
+}
+
+// -- Split each distinct pooled value of 'field' once; games with the same value share the list
+void build_pooled_tokens(PooledStr SteamGame::*field, StringPool& dict, std::vector<std::vector<uint32_t>>& tokens) {
+    tokens.assign(string_pool.size(), {});
+    std::vector<bool> done(string_pool.size(), false);
+    for (const auto& game : structured_games) {
+        uint32_t id = (game.*field).id;
+        if (done[id]) continue;
+        done[id] = true;
+
+        std::stringstream ss(string_pool.get(id));
+        std::string token;
+        while (std::getline(ss, token, ',')) {
+            token.erase(std::remove_if(token.begin(), token.end(), ::isspace), token.end());
+            if (!token.empty()) tokens[id].push_back(dict.insert(token));
+        }
+    }
+}
+
+void build_language_tokens() {
+    build_pooled_tokens(&SteamGame::languages, language_dict, language_tokens);
+}
+
+// Only the histogram benchmark reads tags, so they are split on demand
+void build_tag_tokens() {
+    tag_dict.clear();
+    build_pooled_tokens(&SteamGame::popular_tags, tag_dict, tag_tokens);
+}
+
+// -- Fold worker pools into the global ones, then rewrite handles and append games in task order
+void collect_games(std::vector<std::vector<SteamGame>>& results, const std::vector<unsigned int>& pool_of,
+                   std::vector<StringPool>& pools, std::vector<StringPool>& genre_pools, bool reset_dicts) {
+    unsigned int workers = static_cast<unsigned int>(pools.size());
+    size_t task_count = results.size();
+    string_pool.clear();
+    if (reset_dicts) {
+        genre_dict.clear();
+        language_dict.clear();
+    }
+    std::vector<std::vector<uint32_t>> remaps(workers), genre_remaps(workers);
+    for (unsigned int w = 0; w < workers; ++w) {
+        remaps[w] = string_pool.merge_from(pools[w]);
+        genre_remaps[w] = genre_dict.merge_from(genre_pools[w]);
+    }
+    for (size_t t = 0; t < task_count; ++t) {
+        const auto& remap = remaps[pool_of[t]];
+        const auto& genre_remap = genre_remaps[pool_of[t]];
+        for (auto& game : results[t]) {
+            game.developer.id    = remap[game.developer.id];
+            game.publisher.id    = remap[game.publisher.id];
+            game.popular_tags.id = remap[game.popular_tags.id];
+            game.languages.id    = remap[game.languages.id];
+            for (auto& id : game.genre_ids) id = genre_remap[id];
+        }
+        structured_games.insert(structured_games.end(), std::make_move_iterator(results[t].begin()),
+                                std::make_move_iterator(results[t].end()));
+    }
+    build_language_tokens();
+
+    std::cout << "✅ Structured " << structured_games.size() << " games successfully.\n";
+}
+
+// -- Main formatter; rows are parsed in small tasks on the pool, and each task interns
+// into the pools of the worker that ran it. Out-of-core batches keep the token dictionaries.
+const size_t FORMAT_GRAIN = 256;
+
+void format_all_games(bool reset_dicts = true) {
+    structured_games.clear();
+
+    unsigned int workers = thread_pool().slots();
+    size_t total = rawRows.size();
+    size_t grain = grain_for(FORMAT_GRAIN);
+    size_t task_count = (total + grain - 1) / grain;
+
+    std::vector<std::vector<SteamGame>> results(task_count);
+    std::vector<unsigned int> pool_of(task_count);
+    std::vector<StringPool> pools(workers), genre_pools(workers);
+
+    parallel_for("format_all_games", 0, total, grain, [&](size_t lo, size_t hi) {
+        unsigned int w = current_worker;
+        pool_of[lo / grain] = w;
+        parse_chunk(rawRows, lo, hi, results[lo / grain], pools[w], genre_pools[w]);
+    });
+
+    collect_games(results, pool_of, pools, genre_pools, reset_dicts);
+}
+
+// ===================== Export Formatted Structured Rows =====================
+
+void export_structured_debug(const std::string& filename = "formatted_debug.csv") {
+    std::string header = "name,release_date,developer,publisher,original_price,all_reviews_percent,"
+                         "recent_reviews_percent,overall_genre,languages,min_requirements,rec_requirements\n";
+
+    write_csv(filename, header, structured_games.size(), [](std::string& out, size_t i) {
+        const auto& g = structured_games[i];
+        CsvLine(out)
+            .field(g.name)
+            .field(g.release_date)
+            .field(g.developer.str())
+            .field(g.publisher.str())
+            .number(g.original_price)
+            .number(g.all_reviews_percent)
+            .number(g.recent_reviews_percent)
+            .field(g.overall_genre)
+            .field(g.languages.str())
+            .field(g.minimum_requirements)
+            .field(g.recommended_requirements)
+            .end();
+    });
+    std::cout << "📁 Structured export saved to " << filename << "\n";
+}
+
+// ===================== Part 3b: Compact Numeric Columns =====================
+// The column store and its views are in steam_common.h; built here in parallel chunks.
+
+const size_t COMPACT_GRAIN = 4096;
+
+void build_compact_columns() {
+    size_t total = structured_games.size();
+    compact_columns.reset(total);
+
+    size_t grain = (grain_for(COMPACT_GRAIN) + 63) / 64 * 64;   // whole bitmap words per task
+    parallel_for("build_compact_columns", 0, total, grain, fill_compact_columns);
+
+    std::cout << "🗜️  Compact columns built: " << compact_columns.bytes() << " bytes for " << total << " games\n";
+}
+
+// ===================== Part 3c: Pipelined Load + Parse =====================
+// With --pipeline the SQLite reader pushes batches of raw rows into a bounded
+// single-producer/single-consumer ring. The consuming stage pops each batch and submits it
+// to the pool as a parse task straight away, so formatting overlaps the rest of the read
+// instead of waiting for load_raw_rows to finish. The reader is itself a pool task: it
+// reads until the ring is full and returns, and the consumer resubmits it once a slot
+// frees up, so no thread is started per run and neither side spins. Ring depth and
+// full/empty stalls are recorded for tuning --ring-capacity and the batch size (--grain).
+
+// -- Lock-free bounded ring for one producer and one consumer at a time. Indices grow
+// without wrapping; the capacity is a power of two so a slot is 'index & mask'.
+template <class T>
+struct SpscRing {
+    std::vector<T> slots;
+    size_t mask;
+    alignas(64) std::atomic<size_t> head{0};   // next slot to pop, written by the consumer
+    alignas(64) std::atomic<size_t> tail{0};   // next slot to push, written by the producer
+
+    explicit SpscRing(size_t capacity) {
+        size_t n = 1;
+        while (n < capacity) n <<= 1;
+        slots.resize(n);
+        mask = n - 1;
+    }
+
+    size_t capacity() const { return slots.size(); }
+    size_t size() const { return tail.load(std::memory_order_acquire) - head.load(std::memory_order_acquire); }
+
+    bool try_push(T& value) {
+        size_t t = tail.load(std::memory_order_relaxed);
+        if (t - head.load(std::memory_order_acquire) == slots.size()) return false;
+        slots[t & mask] = std::move(value);
+        tail.store(t + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool try_pop(T& value) {
+        size_t h = head.load(std::memory_order_relaxed);
+        if (h == tail.load(std::memory_order_acquire)) return false;
+        value = std::move(slots[h & mask]);
+        head.store(h + 1, std::memory_order_release);
+        return true;
+    }
+};
+
+struct PipelineStats {
+    size_t capacity = 0;            // ring slots (batches)
+    size_t batch_rows = 0;
+    size_t batches = 0;
+    size_t rows = 0;
+    size_t max_depth = 0;           // batches waiting in the ring, seen by each pop
+    size_t depth_sum = 0;
+    size_t producer_stalls = 0;     // pushes that found the ring full
+    size_t consumer_stalls = 0;     // pops that found the ring empty
+    long long producer_stall_us = 0;
+    long long consumer_stall_us = 0;
+    long long read_us = 0;          // reader, prepare to last row
+};
+
+bool use_pipeline = false;        // --pipeline
+size_t ring_capacity = 16;        // --ring-capacity BATCHES
+PipelineStats pipeline_stats;
+
+// -- Load up to 'limit' rows and format them with reading and parsing overlapped.
+// Leaves rawRows and structured_games exactly as load_raw_rows + format_all_games would.
+void load_and_format_pipelined(int limit) {
+    using Batch = std::vector<RawSteamRow>;
+    pipeline_stats = PipelineStats();
+    structured_games.clear();
+
+    SpscRing<Batch> ring(ring_capacity);
+    size_t batch_rows = grain_for(FORMAT_GRAIN);
+    pipeline_stats.capacity = ring.capacity();
+    pipeline_stats.batch_rows = batch_rows;
+
+    // Reader state survives between its tasks; only one reader task is in flight at a
+    // time, and the consumer reads reader_done only after reader_running drops
+    ThreadPool& pool = thread_pool();
+    auto read_start = std::chrono::steady_clock::now();
+    std::string query = "SELECT * FROM steam_games LIMIT " + std::to_string(limit) + ";";
+    sqlite3_stmt* stmt = nullptr;
+    bool reader_done = false;
+    bool exhausted = false;   // sqlite3_step() returned something other than a row
+    bool parked = false;      // the last reader task returned on a full ring
+    std::chrono::steady_clock::time_point parked_at;
+    Batch pending;            // rows read but not yet pushed
+    std::atomic<bool> reader_running{false};
+    std::mutex wake_lock;
+    std::condition_variable wake;   // the reader pushed a batch or returned
+    TaskBatch reader_tasks;
+    reader_tasks.label = "sqlite reader";
+    if (sqlite3_prepare_v2(db, query.c_str(), -1, &stmt, nullptr) != SQLITE_OK) {
+        std::cerr << "❌ Failed SELECT\n";
+        reader_done = true;
+    } else {
+        pending.reserve(batch_rows);
+    }
+
+    auto read_rows = [&] {
+        TraceScope scope("sqlite", "SELECT steam_games (pipelined)");
+        if (parked) {
+            pipeline_stats.producer_stall_us += std::chrono::duration_cast<std::chrono::microseconds>(
+                std::chrono::steady_clock::now() - parked_at).count();
+            parked = false;
+        }
+        while (true) {
+            while (!exhausted && pending.size() < batch_rows) {
+                if (sqlite3_step(stmt) == SQLITE_ROW) pending.push_back(read_raw_row(stmt));
+                else exhausted = true;
+            }
+            if (pending.empty()) break;
+            size_t rows = pending.size();
+            if (!ring.try_push(pending)) {
+                TraceScope stall("pipeline", "ring full");
+                pipeline_stats.producer_stalls++;
+                parked = true;
+                parked_at = std::chrono::steady_clock::now();
+                break;
+            }
+            live_metrics.rows_ingested.fetch_add(rows, std::memory_order_relaxed);
+            pending = Batch();
+            pending.reserve(batch_rows);
+            {
+                std::lock_guard<std::mutex> guard(wake_lock);
+            }
+            wake.notify_one();
+        }
+        if (exhausted && pending.empty()) {
+            sqlite3_finalize(stmt);
+            pipeline_stats.read_us = std::chrono::duration_cast<std::chrono::microseconds>(
+                std::chrono::steady_clock::now() - read_start).count();
+            reader_done = true;
+        }
+        std::lock_guard<std::mutex> guard(wake_lock);
+        reader_running.store(false, std::memory_order_release);
+        wake.notify_one();
+    };
+
+    // -- Hand the reader to the pool unless it is running, finished or would find the ring full
+    auto resume_reader = [&] {
+        if (reader_running.load(std::memory_order_acquire) || reader_done) return;
+        if (ring.size() == ring.capacity()) return;
+        reader_running.store(true, std::memory_order_relaxed);
+        pool.submit(read_rows, reader_tasks);
+    };
+
+    // Batches and their results live in deques so running tasks keep valid references
+    // while later batches are appended
+    unsigned int workers = pool.slots();
+    std::deque<Batch> batches;
+    std::deque<std::vector<SteamGame>> parsed;
+    std::deque<unsigned int> parsed_by;
+    std::vector<StringPool> pools(workers), genre_pools(workers);
+    TaskBatch tasks;
+    tasks.label = "parse_chunk";
+    auto start = std::chrono::steady_clock::now();
+
+    Batch batch;
+    resume_reader();
+    while (true) {
+        size_t depth = ring.size();
+        if (depth == 0) {
+            // The reader pushes before it drops reader_running, so an empty ring after a
+            // finished reader is final
+            if (!reader_running.load(std::memory_order_acquire) && reader_done && ring.size() == 0) break;
+            resume_reader();
+            TraceScope stall("pipeline", "ring empty");
+            pipeline_stats.consumer_stalls++;
+            auto s0 = std::chrono::steady_clock::now();
+            // Run the reader here if no worker has picked it up yet (a one-worker pool
+            // may be running this stage), else sleep until it pushes or returns
+            if (!pool.run_one(reader_tasks)) {
+                std::unique_lock<std::mutex> guard(wake_lock);
+                wake.wait(guard, [&] { return ring.size() > 0 || !reader_running.load(std::memory_order_acquire); });
+            }
+            pipeline_stats.consumer_stall_us += std::chrono::duration_cast<std::chrono::microseconds>(
+                std::chrono::steady_clock::now() - s0).count();
+            continue;
+        }
+        pipeline_stats.max_depth = std::max(pipeline_stats.max_depth, depth);
+        pipeline_stats.depth_sum += depth;
+        live_metrics.ring_depth.store(depth - 1, std::memory_order_relaxed);
+        ring.try_pop(batch);
+        resume_reader();   // a slot just freed up
+
+        batches.push_back(std::move(batch));
+        parsed.emplace_back();
+        parsed_by.push_back(0);
+        const Batch* rows = &batches.back();
+        std::vector<SteamGame>* out = &parsed.back();
+        unsigned int* owner = &parsed_by.back();
+        pool.submit([rows, out, owner, &pools, &genre_pools] {
+            unsigned int w = current_worker;
+            *owner = w;
+            parse_chunk(*rows, 0, rows->size(), *out, pools[w], genre_pools[w]);
+        }, tasks);
+    }
+    pool.wait(tasks);
+    pool.wait(reader_tasks);
+    long long wall_us = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+    log_batch("format_all_games (pipelined)", batches.size(), tasks, wall_us);
+
+    std::vector<std::vector<SteamGame>> results(std::make_move_iterator(parsed.begin()),
+                                                std::make_move_iterator(parsed.end()));
+    std::vector<unsigned int> pool_of(parsed_by.begin(), parsed_by.end());
+    collect_games(results, pool_of, pools, genre_pools, true);
+
+    rawRows.clear();
+    for (auto& b : batches)
+        rawRows.insert(rawRows.end(), std::make_move_iterator(b.begin()), std::make_move_iterator(b.end()));
+    pipeline_stats.batches = batches.size();
+    pipeline_stats.rows = rawRows.size();
+    std::cout << "🔀 Pipelined " << rawRows.size() << " rows in " << batches.size() << " batches ("
+              << pipeline_stats.producer_stalls << " full / " << pipeline_stats.consumer_stalls << " empty stalls)\n";
+}
+
+// ===================== Part 4: System Requirements Analyzer =====================
+
+SystemSpec min_required_system, rec_required_system;
+
+// -- Folds the specs of games[start, end) into min_acc/rec_acc
+void analyze_chunk(int start, int end, const std::vector<SteamGame>& games,
+                   SystemSpec& min_acc, SystemSpec& rec_acc) {
+    for (int i = start; i < end; ++i) {
+        take_max(min_acc, parse_spec_block(games[i].minimum_requirements));
+        take_max(rec_acc, parse_spec_block(games[i].recommended_requirements));
+    }
+}
+
+// -- Fold the specs of structured_games into min/rec_required_system, one partial
+// result per task.
+const size_t REQUIREMENT_GRAIN = 64;
+
+void accumulate_system_requirements() {
+    size_t total = structured_games.size();
+    size_t grain = grain_for(REQUIREMENT_GRAIN);
+    size_t task_count = (total + grain - 1) / grain;
+    std::vector<SystemSpec> task_min(task_count), task_rec(task_count);
+
+    parallel_for("analyze_system_requirements", 0, total, grain, [&](size_t lo, size_t hi) {
+        analyze_chunk(lo, hi, structured_games, task_min[lo / grain], task_rec[lo / grain]);
+    });
+
+    for (size_t t = 0; t < task_count; ++t) {
+        take_max(min_required_system, task_min[t]);
+        take_max(rec_required_system, task_rec[t]);
+    }
+}
+
+void print_system_requirements() {
+    std::cout << "\nMinimum System Requirements:\n";
+    std::cout << "   OS:      " << min_required_system.os << "\n";
+    std::cout << "   CPU:     " << min_required_system.cpu << "\n";
+    std::cout << "   GPU:     " << min_required_system.gpu << "\n";
+    std::cout << "   RAM:     " << min_required_system.ram_gb << " GB\n";
+    std::cout << "   Storage: " << min_required_system.storage_gb << " GB\n";
+
+    std::cout << "\nRecommended System Requirements:\n";
+    std::cout << "   OS:      " << rec_required_system.os << "\n";
+    std::cout << "   CPU:     " << rec_required_system.cpu << "\n";
+    std::cout << "   GPU:     " << rec_required_system.gpu << "\n";
+    std::cout << "   RAM:     " << rec_required_system.ram_gb << " GB\n";
+    std::cout << "   Storage: " << rec_required_system.storage_gb << " GB\n";
+}
+
+// -- Main analyzer. Both specs start empty every run, as in Sequential.cpp, so a smaller
+// limit after a larger one does not keep the larger run's maxima (the out-of-core path
+// resets them in stream_out_of_core and accumulates batch by batch).
+void analyze_system_requirements() {
+    min_required_system = {};
+    rec_required_system = {};
+    accumulate_system_requirements();
+    print_system_requirements();
+}
+
+// -- Export results
+void export_requirements_debug(const std::string& filename = "system_requirements_summary.csv") {
+    const SystemSpec* specs[] = {&min_required_system, &rec_required_system};
+    const char* types[] = {"Minimum", "Recommended"};
+    write_csv(filename, "Type,OS,CPU,GPU,RAM (GB),Storage (GB)\n", 2, [&](std::string& out, size_t i) {
+        const SystemSpec& spec = *specs[i];
+        CsvLine(out)
+            .text(types[i])
+            .field(spec.os)
+            .field(spec.cpu)
+            .field(spec.gpu)
+            .number(spec.ram_gb)
+            .number(spec.storage_gb)
+            .end();
+    });
+    std::cout << "📄 System requirements summary saved to " << filename << "\n";
+}
+
+// ===================== Part 5: Top Games and Genres ===================== 
+
+// -- Should the next row in rank order still be taken, given what has been taken so far?
+bool takes_next(const TopKQuery& q, size_t taken, float last_rating, float rating) {
+    if (taken < q.k) return true;
+    return q.ties == TiePolicy::KeepTies && rating == last_rating;
+}
+
+// -- Bounded heap over positions [begin, end) of 'rows' (or of all rows when null);
+// rated, named games only
+template <class View>
+std::vector<RankedRow> select_top_chunk(const View& v, const std::vector<size_t>* rows,
+                                        size_t begin, size_t end, const TopKQuery& q) {
+    auto eligible = [&](size_t r) { return v.has_all(r) && !structured_games[r].name.empty(); };
+
+    std::vector<RankedRow> heap;  // heap front is the worst row kept
+    heap.reserve(q.k);
+    for (size_t j = begin; j < end; ++j) {
+        size_t r = rows ? (*rows)[j] : j;
+        if (!eligible(r)) continue;
+
+        RankedRow cand{ v.rating(r), r };
+        if (heap.size() < q.k) {
+            heap.push_back(cand);
+            std::push_heap(heap.begin(), heap.end(), ranks_before);
+        } else if (ranks_before(cand, heap.front())) {
+            std::pop_heap(heap.begin(), heap.end(), ranks_before);
+            heap.back() = cand;
+            std::push_heap(heap.begin(), heap.end(), ranks_before);
+        }
+    }
+
+    // Rows tied with the worst kept row but ranked after it were dropped by the heap
+    if (q.ties == TiePolicy::KeepTies && heap.size() == q.k) {
+        RankedRow worst = heap.front();
+        for (size_t j = begin; j < end; ++j) {
+            size_t r = rows ? (*rows)[j] : j;
+            if (r > worst.row && eligible(r) && v.rating(r) == worst.rating) heap.push_back({ worst.rating, r });
+        }
+    }
+    return heap;
+}
+
+// -- Parallel selection: one bounded heap per chunk, then a merge of the survivors
+const size_t SELECT_GRAIN = 8192;
+
+template <class View>
+std::vector<RankedRow> select_top(const View& v, const std::vector<size_t>* rows, size_t n, const TopKQuery& q) {
+    size_t grain = grain_for(SELECT_GRAIN);
+    std::vector<std::vector<RankedRow>> local((n + grain - 1) / grain);
+
+    parallel_for("compute_top_games", 0, n, grain, [&](size_t lo, size_t hi) {
+        local[lo / grain] = select_top_chunk(v, rows, lo, hi, q);
+    });
+
+    std::vector<RankedRow> merged;
+    for (const auto& part : local) merged.insert(merged.end(), part.begin(), part.end());
+    std::sort(merged.begin(), merged.end(), ranks_before);
+
+    std::vector<RankedRow> result;
+    for (const auto& r : merged) {
+        if (!takes_next(q, result.size(), result.empty() ? r.rating : result.back().rating, r.rating)) break;
+        result.push_back(r);
+    }
+    return result;
+}
+
+std::vector<RankedRow> select_top(const std::vector<size_t>* rows, size_t n, const TopKQuery& q) {
+    return use_compact_columns ? select_top(CompactColumnsView{compact_columns}, rows, n, q)
+                               : select_top(FloatColumnsView{structured_games}, rows, n, q);
+}
+
+void compute_top_games() {
+    top_games.clear();
+    std::vector<RankedRow> best = select_top(nullptr, structured_games.size(), top_games_query);
+    for (const auto& r : best) {
+        const SteamGame& game = structured_games[r.row];
+        top_games.push_back({game.name, game.developer.str(), r.rating, game.original_price, game.release_date});
+    }
+
+    float top_rating = best.empty() ? -1.0f : best.front().rating;
+    std::cout << "🎮 Top Games with " << top_rating << "% rating: " << top_games.size() << " found.\n";
+}
+
+// Top 5 by count; equal counts are ordered by name so the pick is deterministic
+void select_top_genres(const std::vector<std::pair<std::string, int>>& counts) {
+    std::vector<std::pair<std::string, int>> sorted = counts;
+    std::sort(sorted.begin(), sorted.end(), [](auto& a, auto& b) {
+        return a.second != b.second ? a.second > b.second : a.first < b.first;
+    });
+
+    top_genres.assign(sorted.begin(), sorted.begin() + std::min<size_t>(5, sorted.size()));
+
+    std::cout << "🎯 Top Genres:\n";
+    for (const auto& [genre, count] : top_genres)
+        std::cout << " - " << genre << " (" << count << " games)\n";
+}
+
+// -- Fixed-capacity open-addressing map from a 64-bit key (an interned id or a string hash)
+// to a counter, shared by all threads. A slot is claimed with one CAS on its key and counts
+// are fetch_adds, so add() never blocks. No erase and no resize: size it for the number of
+// distinct keys up front. The all-ones key is reserved for empty slots.
+struct CountingMap {
+    static constexpr uint64_t EMPTY = ~0ULL;
+
+    struct Slot {
+        std::atomic<uint64_t> key{EMPTY};
+        std::atomic<long long> count{0};
+    };
+
+    std::unique_ptr<Slot[]> slots;
+    unsigned int bits = 4;
+
+    explicit CountingMap(size_t expected_keys) {
+        while ((size_t(1) << bits) < 2 * expected_keys) bits++;   // load factor <= 0.5
+        slots.reset(new Slot[size_t(1) << bits]);
+    }
+
+    size_t capacity() const { return size_t(1) << bits; }
+
+    // -- Returns false only when every slot holds another key
+    bool add(uint64_t key, long long n = 1) {
+        size_t mask = capacity() - 1;
+        size_t i = static_cast<size_t>((key * 0x9E3779B97F4A7C15ull) >> (64 - bits));   // spreads dense ids
+        for (size_t probe = 0; probe <= mask; ++probe, i = (i + 1) & mask) {
+            uint64_t k = slots[i].key.load(std::memory_order_acquire);
+            if (k == EMPTY) {
+                uint64_t expected = EMPTY;
+                k = slots[i].key.compare_exchange_strong(expected, key, std::memory_order_acq_rel) ? key : expected;
+            }
+            if (k == key) {
+                slots[i].count.fetch_add(n, std::memory_order_relaxed);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // -- (key, count) for every used slot, by key; call once the adding threads are done
+    std::vector<std::pair<uint64_t, long long>> snapshot() const {
+        std::vector<std::pair<uint64_t, long long>> out;
+        for (size_t i = 0; i < capacity(); ++i) {
+            uint64_t k = slots[i].key.load(std::memory_order_acquire);
+            if (k != EMPTY) out.emplace_back(k, slots[i].count.load(std::memory_order_relaxed));
+        }
+        std::sort(out.begin(), out.end());
+        return out;
+    }
+};
+
+// How parallel token histograms combine their counts (--histogram)
+enum class HistogramMode { ThreadLocal, Atomic, Mutex };
+
+HistogramMode histogram_mode = HistogramMode::ThreadLocal;
+
+const char* histogram_mode_name(HistogramMode mode) {
+    switch (mode) {
+    case HistogramMode::Atomic: return "atomic";
+    case HistogramMode::Mutex:  return "mutex";
+    default:                    return "local";
+    }
+}
+
+// -- Count token ids (genre, language, tag) over all games, split into 'threads' slices that
+// run as that many pool tasks. ThreadLocal gives each slice a dense array and combines them
+// with a pairwise tree reduction; Atomic has every slice add into one CountingMap; Mutex
+// guards one shared map with a lock per increment (the baseline the other two replace).
+template <class TokensOf>
+std::vector<int> token_histogram(size_t dict_size, TokensOf tokens_of, unsigned int threads,
+                                 HistogramMode mode, const std::string& label = "") {
+    size_t total = structured_games.size();
+    size_t chunk = (total + threads - 1) / threads;
+    auto slice = [&](size_t t, auto&& count) {
+        for (size_t i = t * chunk; i < std::min(total, (t + 1) * chunk); ++i)
+            for (uint32_t id : tokens_of(i)) count(id);
+    };
+    std::vector<int> histogram(dict_size, 0);
+
+    if (mode == HistogramMode::Atomic) {
+        CountingMap shared(dict_size);
+        parallel_for(label, 0, threads, 1, [&](size_t t, size_t) {
+            slice(t, [&](uint32_t id) { shared.add(id); });
+        });
+        for (const auto& [id, n] : shared.snapshot()) histogram[id] = static_cast<int>(n);
+        return histogram;
+    }
+
+    if (mode == HistogramMode::Mutex) {
+        std::unordered_map<uint32_t, int> shared;
+        std::mutex lock;
+        parallel_for(label, 0, threads, 1, [&](size_t t, size_t) {
+            slice(t, [&](uint32_t id) {
+                std::lock_guard<std::mutex> guard(lock);
+                shared[id]++;
+            });
+        });
+        for (const auto& [id, n] : shared) histogram[id] = n;
+        return histogram;
+    }
+
+    std::vector<std::vector<int>> counts(threads, std::vector<int>(dict_size, 0));
+    parallel_for(label, 0, threads, 1, [&](size_t t, size_t) {
+        std::vector<int>& local = counts[t];
+        slice(t, [&](uint32_t id) { local[id]++; });
+    });
+
+    for (unsigned int stride = 1; stride < threads; stride *= 2) {
+        parallel_for(label, 0, threads, 2 * stride, [&](size_t t, size_t) {
+            if (t + stride < threads)
+                for (size_t id = 0; id < counts[t].size(); ++id) counts[t][id] += counts[t + stride][id];
+        });
+    }
+    return counts[0];
+}
+
+const std::vector<uint32_t>& genre_ids_of(size_t r)    { return structured_games[r].genre_ids; }
+const std::vector<uint32_t>& language_ids_of(size_t r) { return language_tokens[structured_games[r].languages.id]; }
+const std::vector<uint32_t>& tag_ids_of(size_t r)      { return tag_tokens[structured_games[r].popular_tags.id]; }
+
+std::vector<int> genre_histogram(unsigned int threads, const std::string& label = "",
+                                 HistogramMode mode = HistogramMode::ThreadLocal) {
+    return token_histogram(genre_dict.size(), genre_ids_of, threads, mode, label);
+}
+
+void compute_top_genres() {
+    std::vector<int> histogram = genre_histogram(thread_pool().size(), "compute_top_genres", histogram_mode);
+    std::vector<std::pair<std::string, int>> genre_count;
+    for (uint32_t id = 1; id < histogram.size(); ++id)
+        if (histogram[id] > 0) genre_count.emplace_back(genre_dict.get(id), histogram[id]);
+
+    select_top_genres(genre_count);
+}
+
+// -- Time genre_histogram at 1, 2, 4, ... threads for the current input (best of 3 runs)
+void log_genre_scaling(int limit, std::ofstream& log) {
+    unsigned int max_threads = thread_pool().size();
+    double base_us = 0;
+    for (unsigned int threads = 1; ; threads = std::min(threads * 2, max_threads)) {
+        double best_us = 0;
+        for (int rep = 0; rep < 3; ++rep) {
+            auto start = std::chrono::steady_clock::now();
+            genre_histogram(threads);
+            double us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+            if (rep == 0 || us < best_us) best_us = us;
+        }
+        if (threads == 1) base_us = best_us;
+        log << limit << "," << threads << "," << best_us << "," << (best_us > 0 ? base_us / best_us : 0) << "\n";
+        if (threads == max_threads) break;
+    }
+}
+
+// -- Time each histogram variant on genre, language and tag ids at 1, 2, 4, ... threads
+// (best of 3 runs); speedup is against the thread-local variant on one thread
+void log_histogram_variants(int limit, std::ofstream& log) {
+    build_tag_tokens();
+    struct Source {
+        const char* name;
+        size_t dict_size;
+        const std::vector<uint32_t>& (*tokens_of)(size_t);
+    };
+    const Source sources[] = {
+        {"genre", genre_dict.size(), genre_ids_of},
+        {"language", language_dict.size(), language_ids_of},
+        {"tag", tag_dict.size(), tag_ids_of},
+    };
+    const HistogramMode modes[] = {HistogramMode::ThreadLocal, HistogramMode::Atomic, HistogramMode::Mutex};
+    unsigned int max_threads = thread_pool().size();
+
+    for (const auto& src : sources) {
+        double base_us = 0;
+        for (HistogramMode mode : modes) {
+            for (unsigned int threads = 1; ; threads = std::min(threads * 2, max_threads)) {
+                double best_us = 0;
+                for (int rep = 0; rep < 3; ++rep) {
+                    auto start = std::chrono::steady_clock::now();
+                    token_histogram(src.dict_size, src.tokens_of, threads, mode);
+                    double us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+                    if (rep == 0 || us < best_us) best_us = us;
+                }
+                if (mode == HistogramMode::ThreadLocal && threads == 1) base_us = best_us;
+                log << limit << "," << src.name << "," << histogram_mode_name(mode) << "," << threads << ","
+                    << best_us << "," << (best_us > 0 ? base_us / best_us : 0) << "\n";
+                if (threads == max_threads) break;
+            }
+        }
+    }
+}
+
+// -- Export functions
+void export_top_games(const std::string& filename = "top_5_games.csv") {
+    write_csv(filename, "Name,Developer,Rating,Price,ReleaseDate\n", top_games.size(),
+              [](std::string& out, size_t i) {
+        const auto& g = top_games[i];
+        CsvLine(out)
+            .field(g.name)
+            .field(g.developer)
+            .number(g.rating)
+            .number(g.price)
+            .field(g.release_date)
+            .end();
+    });
+    std::cout << "📄 Top 5 games export saved to " << filename << "\n";
+}
+
+void export_top_genres(const std::string& filename = "top_5_genres.csv") {
+    write_csv(filename, "Genre,Count\n", top_genres.size(), [](std::string& out, size_t i) {
+        CsvLine(out).field(top_genres[i].first).number(top_genres[i].second).end();
+    });
+    std::cout << "📄 Top 5 genres export saved to " << filename << "\n";
+}
+
+// ===================== Part 5b: Group-By Aggregation Engine =====================
+// The engine (key columns, aggregate functors, merge_into, GroupByReport) is shared with
+// the sequential pipeline through steam_common.h. Here a report runs radix-partitioned on
+// the scheduler; Part 7b runs it per out-of-core batch and merges the spilled states.
+
+// -- Radix partition of a key hash; the multiply spreads dense pool ids over the top bits
+size_t partition_of(size_t hash, unsigned int bits) {
+    return bits == 0 ? 0 : static_cast<size_t>((uint64_t(hash) * 0x9E3779B97F4A7C15ull) >> (64 - bits));
+}
+
+// -- Two-phase radix-partitioned aggregation on the scheduler. Phase 1: tasks scatter the
+// row ids of a slice into partitions by key hash. Phase 2: one task per partition aggregates
+// and finishes it in a private table, so no table is shared or merged. Partitions are
+// small, so a skewed key occupies one worker while the rest steal the others.
+const size_t SCATTER_GRAIN = 4096;
+
+template <class Report, class View>
+auto run_report(const std::string& label, const Report& report, const View& v) {
+    using KeyCol = typename Report::KeyColumn;
+    unsigned int bits = 0;
+    while ((1u << bits) < thread_pool().size() * 16) bits++;
+    size_t partitions = size_t(1) << bits;
+
+    size_t total = structured_games.size();
+    size_t grain = grain_for(SCATTER_GRAIN);
+    size_t slices = (total + grain - 1) / grain;
+    std::vector<std::vector<std::vector<uint32_t>>> scatter(slices);   // [slice][partition] -> rows
+
+    parallel_for(label + " (scatter)", 0, total, grain, [&](size_t lo, size_t hi) {
+        auto& parts = scatter[lo / grain];
+        parts.resize(partitions);
+        std::hash<typename KeyCol::Key> hash;
+        for (size_t r = lo; r < hi; ++r)
+            if (KeyCol::valid(r)) parts[partition_of(hash(KeyCol::key(r)), bits)].push_back(static_cast<uint32_t>(r));
+    });
+
+    std::vector<std::vector<typename Report::Row>> results(partitions);
+    parallel_for(label + " (aggregate)", 0, partitions, 1, [&](size_t p, size_t) {
+        typename Report::Table table;
+        for (size_t s = 0; s < slices; ++s)   // slices in order keep rows ascending
+            for (uint32_t r : scatter[s][p])
+                report.add(table[KeyCol::key(r)], v, r);
+        for (const auto& [key, states] : table)
+            results[p].push_back(report.finish(KeyCol::name(key), states, v));
+    });
+
+    std::vector<typename Report::Row> rows;
+    for (auto& part : results)
+        rows.insert(rows.end(), std::make_move_iterator(part.begin()), std::make_move_iterator(part.end()));
+    report.sort_rows(rows);
+    return rows;
+}
+
+template <class Report>
+auto run_report(const std::string& label, const Report& report) {
+    return use_compact_columns ? run_report(label, report, CompactColumnsView{compact_columns})
+                               : run_report(label, report, FloatColumnsView{structured_games});
+}
+
+// ===================== Part 6: Developer-Level Stats =====================
+
+void compute_developer_stats() {
+    developer_stats = run_report("compute_developer_stats", developer_report);
+    std::cout << "📊 Developer stats computed: " << developer_stats.size() << "\n";
+}
+
+void export_developer_stats(const std::string& filename = "developer_stats.csv") {
+    std::string header = "Developer,AvgRating,AvgPrice,MostCommonGenre,LeastCommonGenre,MostCommonLanguage,LeastCommonLanguage\n";
+
+    write_csv(filename, header, developer_stats.size(), [](std::string& out, size_t i) {
+        const auto& s = developer_stats[i];
+        CsvLine(out)
+            .field(s.developer)
+            .number(s.avg_rating)
+            .number(s.avg_price)
+            .field(s.most_common_genre)
+            .field(s.least_common_genre)
+            .field(s.most_common_language)
+            .field(s.least_common_language)
+            .end();
+    });
+    std::cout << "📄 Developer stats export saved to " << filename << "\n";
+}
+
+// ===================== Part 7: Publisher-Level Stats =====================
+
+void compute_publisher_stats() {
+    publisher_stats = run_report("compute_publisher_stats", publisher_report);
+    std::cout << "📊 Publisher stats computed: " << publisher_stats.size() << "\n";
 }
 
-// -- Main formatter (parallelized)
-void format_all_games() {
-    structured_games.clear();
-
-    unsigned int threads = std::thread::hardware_concurrency();
-    if (threads == 0) threads = 4;
+void export_publisher_stats(const std::string& filename = "publisher_stats.csv") {
+    std::string header = "Publisher,AvgRating,AvgPrice,MostCommonGenre,LeastCommonGenre,MostCommonLanguage,LeastCommonLanguage\n";
+
+    write_csv(filename, header, publisher_stats.size(), [](std::string& out, size_t i) {
+        const auto& s = publisher_stats[i];
+        CsvLine(out)
+            .field(s.publisher)
+            .number(s.avg_rating)
+            .number(s.avg_price)
+            .field(s.most_common_genre)
+            .field(s.least_common_genre)
+            .field(s.most_common_language)
+            .field(s.least_common_language)
+            .end();
+    });
+    std::cout << "📄 Publisher stats export saved to " << filename << "\n";
+}
 
-    int total = rawRows.size();
-    int chunk = (total + threads - 1) / threads;
+// ===================== Part 7b: Out-of-Core Mode =====================
+// With --memory-budget MB the table is streamed in batches instead of being held as
+// rawRows + structured_games. Developer/publisher/genre partial aggregates and the
+// ranking records for top games stay in memory until half the budget is used, then
+// go to sorted run files that are k-way merged once at the end.
+
+size_t memory_budget_bytes = 0;   // 0 = in-memory path
+std::string spill_dir;            // empty = system temp directory
+
+// -- Partial stats for one developer or publisher: the report's own aggregate states.
+// Token ids stay valid across batches because format_all_games(false) keeps the dictionaries.
+using GroupStates = decltype(developer_report)::States;
+static_assert(std::is_same_v<GroupStates, decltype(publisher_report)::States>,
+              "developer and publisher reports share one state layout");
+
+// -- One game in the external sort for top games
+struct RankRecord {
+    float rating = -1.0f;
+    float price = 0.0f;
+    uint64_t seq = 0;   // global row number; ties keep input order
+    std::string name, release_date, developer;
+};
 
-    std::vector<std::thread> workers;
-    std::vector<std::vector<SteamGame>> results(threads);
+bool rank_before(const RankRecord& a, const RankRecord& b) {
+    if (a.rating != b.rating) return a.rating > b.rating;
+    return a.seq < b.seq;
+}
 
-    for (unsigned int t = 0; t < threads; ++t) {
-        int start = t * chunk;
-        int end = std::min(start + chunk, total);
-        workers.emplace_back(parse_chunk, start, end, std::ref(results[t]));
-    }
+struct SpillState {
+    std::map<std::string, GroupStates> developers, publishers;
+    std::map<std::string, int> genres;
+    std::vector<RankRecord> ranking;
+    size_t bytes = 0;   // estimated heap use of the partial state
+    std::vector<std::string> dev_runs, pub_runs, genre_runs, rank_runs;
+};
 
-    for (auto& w : workers) w.join();
+struct OutOfCoreStats {
+    size_t batches = 0;
+    size_t games = 0;
+    size_t runs = 0;
+    size_t spilled_bytes = 0;
+    size_t peak_state_bytes = 0;
+    size_t unique_genres = 0;
+};
 
-    for (const auto& part : results)
-        structured_games.insert(structured_games.end(), part.begin(), part.end());
+SpillState spill_state;
+OutOfCoreStats ooc_stats;
 
-    std::cout << "✅ Structured " << structured_games.size() << " games successfully.\n";
-}
-// ===================== Export Formatted Structured Rows =====================
+// Rough per-entry cost of a std::map node / vector slot on top of the payload
+const size_t NODE_OVERHEAD = 64;
 
-void export_structured_debug(const std::string& filename = "formatted_debug.csv") {
-    std::ofstream file(filename);
-    file << "name,release_date,developer,publisher,original_price,discount_price,"
-         << "all_reviews_percent,recent_reviews_percent,overall_genre,languages,types,achievements\n";
+// -- Binary run-file encoding
+template <class T>
+void write_pod(std::ostream& out, const T& v) { out.write(reinterpret_cast<const char*>(&v), sizeof(T)); }
 
-    for (const auto& g : structured_games) {
-        file << escape_csv(g.name) << ","
-             << escape_csv(g.release_date) << ","
-             << escape_csv(g.developer) << ","
-             << escape_csv(g.publisher) << ","
-             << g.original_price << ","
-             << g.discount_price << ","
-             << g.all_reviews_percent << ","
-             << g.recent_reviews_percent << ","
-             << escape_csv(g.overall_genre) << ","
-             << escape_csv(g.languages) << ","
-             << escape_csv(g.types) << ","
-             << escape_csv(g.achievements) << "\n";
-    }
+template <class T>
+bool read_pod(std::istream& in, T& v) { return bool(in.read(reinterpret_cast<char*>(&v), sizeof(T))); }
 
-    file.close();
-    std::cout << "📁 Structured export saved to " << filename << "\n";
+void write_value(std::ostream& out, const std::string& s) {
+    write_pod(out, static_cast<uint32_t>(s.size()));
+    out.write(s.data(), s.size());
 }
-// ===================== Part 4: System Requirements Analyzer =====================
-
-struct SystemSpec {
-    std::string os;
-    std::string cpu;
-    std::string gpu;
-    int ram_gb = 0;
-    int storage_gb = 0;
-};
 
-SystemSpec min_required_system, rec_required_system;
-std::mutex spec_mutex;
-
-// -- Helper to extract a number (like "8 GB") from a string
-int extract_number_gb(const std::string& s) {
-    std::stringstream ss(s);
-    std::string token;
-    while (ss >> token) {
-        try {
-            float value = std::stof(token);
-            if (s.find("GB") != std::string::npos || s.find("gb") != std::string::npos)
-                return static_cast<int>(std::ceil(value));
-        } catch (...) {}
-    }
-    return 0;
+bool read_value(std::istream& in, std::string& s) {
+    uint32_t n;
+    if (!read_pod(in, n)) return false;
+    s.resize(n);
+    return n == 0 || bool(in.read(&s[0], n));
 }
 
-// -- Helper to parse each field for system requirements
-void analyze_chunk(int start, int end, const std::vector<SteamGame>& games,
-                   std::vector<SystemSpec>& min_local, std::vector<SystemSpec>& rec_local) {
-    for (int i = start; i < end; ++i) {
-        const auto& game = games[i];
-        SystemSpec min, rec;
+void write_value(std::ostream& out, int v) { write_pod(out, v); }
+bool read_value(std::istream& in, int& v) { return read_pod(in, v); }
 
-        // Extract known fields
-        std::regex os_regex(R"(OS:\s*([^\n\r]+))");
-        std::regex cpu_regex(R"(Processor:\s*([^\n\r]+))");
-        std::regex gpu_regex(R"(Graphics:\s*([^\n\r]+))");
-        std::regex ram_regex(R"(Memory:\s*([^\n\r]+))");
-        std::regex storage_regex(R"(Storage:\s*([^\n\r]+))");
+void write_value(std::ostream& out, const CountState& c) { write_pod(out, c.n); }
+bool read_value(std::istream& in, CountState& c) { return read_pod(in, c.n); }
 
-        std::smatch match;
-        if (std::regex_search(game.minimum_requirements, match, os_regex))      min.os = match[1];
-        if (std::regex_search(game.minimum_requirements, match, cpu_regex))     min.cpu = match[1];
-        if (std::regex_search(game.minimum_requirements, match, gpu_regex))     min.gpu = match[1];
-        if (std::regex_search(game.minimum_requirements, match, ram_regex))     min.ram_gb = extract_number_gb(match[1]);
-        if (std::regex_search(game.minimum_requirements, match, storage_regex)) min.storage_gb = extract_number_gb(match[1]);
+void write_value(std::ostream& out, const SumState& c) { write_pod(out, c.sum); write_pod(out, c.n); }
+bool read_value(std::istream& in, SumState& c) { return read_pod(in, c.sum) && read_pod(in, c.n); }
 
-        if (std::regex_search(game.recommended_requirements, match, os_regex))      rec.os = match[1];
-        if (std::regex_search(game.recommended_requirements, match, cpu_regex))     rec.cpu = match[1];
-        if (std::regex_search(game.recommended_requirements, match, gpu_regex))     rec.gpu = match[1];
-        if (std::regex_search(game.recommended_requirements, match, ram_regex))     rec.ram_gb = extract_number_gb(match[1]);
-        if (std::regex_search(game.recommended_requirements, match, storage_regex)) rec.storage_gb = extract_number_gb(match[1]);
+void write_value(std::ostream& out, const TokenFreq& f) {
+    write_pod(out, static_cast<uint32_t>(f.counts.size()));
+    for (const auto& [id, n] : f.counts) { write_pod(out, id); write_pod(out, n); }
+}
 
-        min_local.push_back(min);
-        rec_local.push_back(rec);
-    }
+bool read_value(std::istream& in, TokenFreq& f) {
+    uint32_t n;
+    if (!read_pod(in, n)) return false;
+    f.counts.resize(n);
+    for (auto& [id, count] : f.counts)
+        if (!read_pod(in, id) || !read_pod(in, count)) return false;
+    return true;
 }
 
-// -- Helper to keep highest value per field
-void take_max(SystemSpec& base, const SystemSpec& new_val) {
-    if (new_val.os.length() > base.os.length()) base.os = new_val.os;
-    if (new_val.cpu.length() > base.cpu.length()) base.cpu = new_val.cpu;
-    if (new_val.gpu.length() > base.gpu.length()) base.gpu = new_val.gpu;
-    if (new_val.ram_gb > base.ram_gb) base.ram_gb = new_val.ram_gb;
-    if (new_val.storage_gb > base.storage_gb) base.storage_gb = new_val.storage_gb;
+template <class... S>
+void write_value(std::ostream& out, const std::tuple<S...>& t) {
+    std::apply([&](const auto&... state) { (write_value(out, state), ...); }, t);
 }
 
-// -- Main analyzer
-void analyze_system_requirements() {
-    unsigned int threads = std::thread::hardware_concurrency();
-    if (threads == 0) threads = 4;
+template <class... S>
+bool read_value(std::istream& in, std::tuple<S...>& t) {
+    return std::apply([&](auto&... state) { return (read_value(in, state) && ...); }, t);
+}
 
-    int total = structured_games.size();
-    int chunk = (total + threads - 1) / threads;
+// -- Heap bytes held by a group's states beyond sizeof
+size_t state_bytes(const CountState&) { return 0; }
+size_t state_bytes(const SumState&) { return 0; }
+size_t state_bytes(const TokenFreq& f) { return f.counts.capacity() * sizeof(f.counts[0]); }
 
-    std::vector<std::thread> workers;
-    std::vector<std::vector<SystemSpec>> local_min(threads), local_rec(threads);
+template <class... S>
+size_t state_bytes(const std::tuple<S...>& t) {
+    return std::apply([](const auto&... state) { return (state_bytes(state) + ... + size_t(0)); }, t);
+}
 
-    for (unsigned int t = 0; t < threads; ++t) {
-        int start = t * chunk;
-        int end = std::min(start + chunk, total);
-        workers.emplace_back(analyze_chunk, start, end, std::ref(structured_games),
-                             std::ref(local_min[t]), std::ref(local_rec[t]));
-    }
+void write_value(std::ostream& out, const RankRecord& r) {
+    write_pod(out, r.rating);
+    write_pod(out, r.price);
+    write_pod(out, r.seq);
+    write_value(out, r.name);
+    write_value(out, r.release_date);
+    write_value(out, r.developer);
+}
 
-    for (auto& w : workers) w.join();
+bool read_value(std::istream& in, RankRecord& r) {
+    return read_pod(in, r.rating) && read_pod(in, r.price) && read_pod(in, r.seq) && read_value(in, r.name) &&
+           read_value(in, r.release_date) && read_value(in, r.developer);
+}
 
-    for (unsigned int t = 0; t < threads; ++t) {
-        for (const auto& spec : local_min[t]) take_max(min_required_system, spec);
-        for (const auto& spec : local_rec[t]) take_max(rec_required_system, spec);
-    }
+std::string next_run_path(const std::string& kind) {
+    static const long long token = std::chrono::steady_clock::now().time_since_epoch().count();
+    std::filesystem::path dir = spill_dir.empty() ? std::filesystem::temp_directory_path()
+                                                  : std::filesystem::path(spill_dir);
+    return (dir / ("steam_" + std::to_string(token) + "_" + kind + "_" +
+                   std::to_string(ooc_stats.runs++) + ".run")).string();
+}
 
-    std::cout << "\nMinimum System Requirements:\n";
-    std::cout << "   OS:      " << min_required_system.os << "\n";
-    std::cout << "   CPU:     " << min_required_system.cpu << "\n";
-    std::cout << "   GPU:     " << min_required_system.gpu << "\n";
-    std::cout << "   RAM:     " << min_required_system.ram_gb << " GB\n";
-    std::cout << "   Storage: " << min_required_system.storage_gb << " GB\n";
+// -- Write a key-sorted map as one run file
+template <class V>
+void spill_map(std::map<std::string, V>& m, const std::string& kind, std::vector<std::string>& runs) {
+    if (m.empty()) return;
+    std::string path = next_run_path(kind);
+    std::ofstream out(path, std::ios::binary);
+    for (const auto& [key, value] : m) {
+        write_value(out, key);
+        write_value(out, value);
+    }
+    ooc_stats.spilled_bytes += out.tellp();
+    runs.push_back(path);
+    m.clear();
+}
 
-    std::cout << "\nRecommended System Requirements:\n";
-    std::cout << "   OS:      " << rec_required_system.os << "\n";
-    std::cout << "   CPU:     " << rec_required_system.cpu << "\n";
-    std::cout << "   GPU:     " << rec_required_system.gpu << "\n";
-    std::cout << "   RAM:     " << rec_required_system.ram_gb << " GB\n";
-    std::cout << "   Storage: " << rec_required_system.storage_gb << " GB\n";
+void spill_ranking(std::vector<RankRecord>& ranking, std::vector<std::string>& runs) {
+    if (ranking.empty()) return;
+    std::stable_sort(ranking.begin(), ranking.end(), rank_before);
+    std::string path = next_run_path("rank");
+    std::ofstream out(path, std::ios::binary);
+    for (const auto& r : ranking) write_value(out, r);
+    ooc_stats.spilled_bytes += out.tellp();
+    runs.push_back(path);
+    ranking.clear();
 }
 
-// -- Export results
-void export_requirements_debug(const std::string& filename = "system_requirements_summary.csv") {
-    std::ofstream file(filename);
-    file << "Field,Minimum,Recommended\n";
-    file << "OS," << escape_csv(min_required_system.os) << "," << escape_csv(rec_required_system.os) << "\n";
-    file << "CPU," << escape_csv(min_required_system.cpu) << "," << escape_csv(rec_required_system.cpu) << "\n";
-    file << "GPU," << escape_csv(min_required_system.gpu) << "," << escape_csv(rec_required_system.gpu) << "\n";
-    file << "RAM," << min_required_system.ram_gb << "," << rec_required_system.ram_gb << "\n";
-    file << "Storage," << min_required_system.storage_gb << "," << rec_required_system.storage_gb << "\n";
-    file.close();
-    std::cout << "📄 System requirements summary saved to " << filename << "\n";
+void spill_all() {
+    auto& st = spill_state;
+    spill_map(st.developers, "dev", st.dev_runs);
+    spill_map(st.publishers, "pub", st.pub_runs);
+    spill_map(st.genres, "genre", st.genre_runs);
+    spill_ranking(st.ranking, st.rank_runs);
+    st.bytes = 0;
 }
-// ===================== Part 5: Top Games and Genres ===================== 
 
-std::vector<SteamGame> top_games;
-std::vector<std::string> top_genres;
+// -- K-way merge of key-sorted runs; emit(key, merged value) is called in key order
+void merge_into(int& a, int b) { a += b; }
 
-void compute_top_games() {
-    std::vector<SteamGame> all = structured_games;
+template <class V, class Emit>
+void merge_runs(const std::vector<std::string>& runs, Emit emit) {
+    struct Cursor {
+        std::ifstream in;
+        std::string key;
+        V value;
+        bool next() { return read_value(in, key) && read_value(in, value); }
+    };
 
-    std::sort(all.begin(), all.end(), [](const SteamGame& a, const SteamGame& b) {
-        return a.all_reviews_percent > b.all_reviews_percent;
-    });
+    std::vector<std::unique_ptr<Cursor>> cursors;
+    auto later = [&](size_t a, size_t b) { return cursors[a]->key > cursors[b]->key; };
+    std::priority_queue<size_t, std::vector<size_t>, decltype(later)> heap(later);
 
-    // Always take all tied highest-rated games (e.g. all 100%)
-    float top_rating = all.empty() ? -1.0f : all.front().all_reviews_percent;
+    for (const auto& path : runs) {
+        cursors.push_back(std::make_unique<Cursor>());
+        cursors.back()->in.open(path, std::ios::binary);
+        if (cursors.back()->next()) heap.push(cursors.size() - 1);
+    }
 
-    for (const auto& g : all) {
-        if (g.all_reviews_percent == top_rating)
-            top_games.push_back(g);
-        else
-            break;
+    while (!heap.empty()) {
+        size_t top = heap.top();
+        heap.pop();
+        std::string key = cursors[top]->key;
+        V value = cursors[top]->value;
+        if (cursors[top]->next()) heap.push(top);
+
+        while (!heap.empty() && cursors[heap.top()]->key == key) {
+            size_t same = heap.top();
+            heap.pop();
+            merge_into(value, cursors[same]->value);
+            if (cursors[same]->next()) heap.push(same);
+        }
+        emit(key, value);
     }
 
-    std::cout << "🎮 Top Games with " << top_rating << "% rating: " << top_games.size() << " found.\n";
+    for (auto& c : cursors) c->in.close();
+    for (const auto& path : runs) std::filesystem::remove(path);
 }
 
-void compute_top_genres() {
-    std::unordered_map<std::string, int> genre_count;
+// -- K-way merge of sorted ranking runs; stops once take(record) returns false
+template <class Take>
+void merge_ranking_runs(const std::vector<std::string>& runs, Take take) {
+    struct Cursor {
+        std::ifstream in;
+        RankRecord rec;
+    };
 
-    for (const auto& g : structured_games) {
-        std::stringstream ss(g.overall_genre);
-        std::string genre;
+    std::vector<std::unique_ptr<Cursor>> cursors;
+    auto later = [&](size_t a, size_t b) { return rank_before(cursors[b]->rec, cursors[a]->rec); };
+    std::priority_queue<size_t, std::vector<size_t>, decltype(later)> heap(later);
 
-        while (std::getline(ss, genre, ',')) {
-            genre.erase(std::remove_if(genre.begin(), genre.end(), ::isspace), genre.end());
-            if (!genre.empty()) genre_count[genre]++;
-        }
+    for (const auto& path : runs) {
+        cursors.push_back(std::make_unique<Cursor>());
+        cursors.back()->in.open(path, std::ios::binary);
+        if (read_value(cursors.back()->in, cursors.back()->rec)) heap.push(cursors.size() - 1);
     }
 
-    std::vector<std::pair<std::string, int>> sorted(genre_count.begin(), genre_count.end());
-    std::sort(sorted.begin(), sorted.end(), [](auto& a, auto& b) {
-        return a.second > b.second;
-    });
-
-    for (int i = 0; i < 5 && i < sorted.size(); ++i) {
-        top_genres.push_back(sorted[i].first);
+    while (!heap.empty()) {
+        size_t top = heap.top();
+        heap.pop();
+        if (!take(cursors[top]->rec)) break;
+        if (read_value(cursors[top]->in, cursors[top]->rec)) heap.push(top);
     }
 
-    std::cout << "🎯 Top Genres:\n";
-    for (const auto& g : top_genres)
-        std::cout << " - " << g << " (" << genre_count[g] << " games)\n";
+    for (auto& c : cursors) c->in.close();
+    for (const auto& path : runs) std::filesystem::remove(path);
 }
 
-// -- Export functions
-void export_top_games(const std::string& filename = "top_5_games.csv") {
-    std::ofstream file(filename);
-    file << "name,release_date,developer,publisher,all_reviews_percent\n";
+// -- Run a report over the current batch and fold its groups into the partial state
+template <class Report>
+void fold_batch(const Report& report, std::map<std::string, GroupStates>& groups) {
+    typename Report::Table table;
+    report.aggregate(FloatColumnsView{structured_games}, 0, structured_games.size(), table);
+
+    for (auto& [key, states] : table) {
+        const std::string& name = Report::KeyColumn::name(key);
+        auto it = groups.find(name);
+        if (it == groups.end()) {
+            spill_state.bytes += name.size() + sizeof(GroupStates) + state_bytes(states) + NODE_OVERHEAD;
+            groups.emplace(name, std::move(states));
+        } else {
+            size_t before = state_bytes(it->second);
+            merge_into(it->second, states);
+            spill_state.bytes += state_bytes(it->second) - before;
+        }
+    }
+}
+
+void aggregate_batch(uint64_t first_seq) {
+    auto& st = spill_state;
+    fold_batch(developer_report, st.developers);
+    fold_batch(publisher_report, st.publishers);
 
-    for (const auto& g : top_games) {
-        file << escape_csv(g.name) << ","
-             << escape_csv(g.release_date) << ","
-             << escape_csv(g.developer) << ","
-             << escape_csv(g.publisher) << ","
-             << g.all_reviews_percent << "\n";
+    for (size_t i = 0; i < structured_games.size(); ++i) {
+        const auto& g = structured_games[i];
+        for (uint32_t id : g.genre_ids) {
+            const std::string& genre = genre_dict.get(id);
+            if (st.genres[genre]++ == 0) st.bytes += genre.size() + NODE_OVERHEAD;
+        }
+        if (g.all_reviews_percent < 0 || g.name.empty()) continue;   // not a top-games candidate
+
+        RankRecord r;
+        r.rating = g.all_reviews_percent;
+        r.price = g.original_price;
+        r.seq = first_seq + i;
+        r.name = g.name;
+        r.release_date = g.release_date;
+        r.developer = g.developer.str();
+        st.bytes += sizeof(RankRecord) + r.name.size() + r.release_date.size() + r.developer.size();
+        st.ranking.push_back(std::move(r));
     }
 
-    file.close();
-    std::cout << "📄 Top 5 games export saved to " << filename << "\n";
+    ooc_stats.peak_state_bytes = std::max(ooc_stats.peak_state_bytes, st.bytes);
+    if (st.bytes > memory_budget_bytes / 2) spill_all();
 }
 
-void export_top_genres(const std::string& filename = "top_5_genres.csv") {
-    std::ofstream file(filename);
-    file << "genre\n";
-    for (const auto& g : top_genres) {
-        file << g << "\n";
-    }
-    file.close();
-    std::cout << "📄 Top 5 genres export saved to " << filename << "\n";
+size_t raw_row_bytes(const RawSteamRow& row) {
+    return sizeof(RawSteamRow) + row.url.size() + row.types.size() + row.name.size() +
+           row.desc_snippet.size() + row.recent_reviews.size() + row.all_reviews.size() +
+           row.release_date.size() + row.developer.size() + row.publisher.size() +
+           row.popular_tags.size() + row.game_details.size() + row.languages.size() +
+           row.achievements.size() + row.genre.size() + row.game_description.size() +
+           row.mature_content.size() + row.minimum_requirements.size() +
+           row.recommended_requirements.size() + row.original_price.size() + row.discount_price.size();
 }
-// ===================== Part 6: Developer-Level Stats =====================
 
-struct DeveloperStats {
-    std::string developer;
-    float avg_all = 0;
-    float avg_recent = 0;
-    float avg_price = 0;
-    std::string common_genre;
-    std::string least_common_genre;
-    std::string common_language;
-    std::string least_common_language;
-    int count = 0;
-};
+// -- Stream up to 'limit' rows in batches of about a quarter of the budget
+void stream_out_of_core(int limit) {
+    spill_state = SpillState();
+    ooc_stats = OutOfCoreStats();
+    min_required_system = {};
+    rec_required_system = {};
+    genre_dict.clear();
+    language_dict.clear();
+
+    std::string query = "SELECT * FROM steam_games LIMIT " + std::to_string(limit) + ";";
+    sqlite3_stmt* stmt;
+    if (sqlite3_prepare_v2(db, query.c_str(), -1, &stmt, nullptr) != SQLITE_OK) {
+        std::cerr << "❌ Failed SELECT\n";
+        return;
+    }
 
-std::vector<DeveloperStats> developer_stats;
+    size_t rows_read = 0;
+    bool more = true;
+    while (more) {
+        rawRows.clear();
+        size_t batch_bytes = 0;
+        {
+            TraceScope scope("sqlite", "SELECT steam_games (batch)");
+            while (batch_bytes < memory_budget_bytes / 4) {
+                if (sqlite3_step(stmt) != SQLITE_ROW) { more = false; break; }
+                rawRows.push_back(read_raw_row(stmt));
+                batch_bytes += raw_row_bytes(rawRows.back());
+            }
+        }
+        if (rawRows.empty()) break;
+        rows_read += rawRows.size();
+        live_metrics.rows_ingested.fetch_add(rawRows.size(), std::memory_order_relaxed);
+
+        format_all_games(false);
+        accumulate_system_requirements();
+        aggregate_batch(ooc_stats.games);
+        ooc_stats.games += structured_games.size();
+        ooc_stats.batches++;
+    }
+    sqlite3_finalize(stmt);
 
-// Helpers to find most/least common in a list
-std::string most_common(const std::vector<std::string>& items) {
-    std::map<std::string, int> freq;
-    for (const auto& item : items)
-        if (!item.empty()) freq[item]++;
-    return freq.empty() ? "" : std::max_element(freq.begin(), freq.end(),
-        [](auto& a, auto& b) { return a.second < b.second; })->first;
+    rawRows.clear();
+    structured_games.clear();
+    std::cout << "💾 Streamed " << rows_read << " rows in " << ooc_stats.batches << " batches, "
+              << ooc_stats.runs << " runs spilled (" << ooc_stats.spilled_bytes << " bytes)\n";
 }
 
-std::string least_common(const std::vector<std::string>& items) {
-    std::map<std::string, int> freq;
-    for (const auto& item : items)
-        if (!item.empty()) freq[item]++;
-    return freq.empty() ? "" : std::min_element(freq.begin(), freq.end(),
-        [](auto& a, auto& b) { return a.second < b.second; })->first;
-}
+// -- Merge spilled runs with the in-memory remainder into the usual result globals
+void merge_out_of_core() {
+    auto& st = spill_state;
+    // Anything still in memory becomes the last run when earlier runs exist
+    if (!st.dev_runs.empty() || !st.pub_runs.empty() || !st.genre_runs.empty() || !st.rank_runs.empty())
+        spill_all();
 
-void compute_developer_stats() {
+    FloatColumnsView view{structured_games};
     developer_stats.clear();
-    std::map<std::string, std::vector<SteamGame>> buckets;
-
-    for (const auto& g : structured_games)
-        if (!g.developer.empty())
-            buckets[g.developer].push_back(g);
-
-    std::vector<std::string> devs;
-    for (const auto& [dev, _] : buckets)
-        devs.push_back(dev);
+    auto emit_dev = [&](const std::string& key, const GroupStates& states) {
+        developer_stats.push_back(developer_report.finish(key, states, view));
+    };
 
-    unsigned int threads = std::thread::hardware_concurrency();
-    if (threads == 0) threads = 4;
-
-    int chunk = (devs.size() + threads - 1) / threads;
-    std::vector<std::thread> workers;
-    std::vector<std::vector<DeveloperStats>> local_results(threads);
-
-    auto work = [&](int start, int end, std::vector<DeveloperStats>& local) {
-        for (int i = start; i < end && i < devs.size(); ++i) {
-            const auto& dev = devs[i];
-            const auto& games = buckets[dev];
-            if (games.empty()) continue;
-
-            DeveloperStats stat;
-            stat.developer = dev;
-            std::vector<std::string> langs, genres;
-            float sum_all = 0, sum_recent = 0, sum_price = 0;
-            int count = 0;
-
-            for (const auto& g : games) {
-                if (g.all_reviews_percent >= 0) sum_all += g.all_reviews_percent;
-                if (g.recent_reviews_percent >= 0) sum_recent += g.recent_reviews_percent;
-                if (g.original_price >= 0) sum_price += g.original_price;
-                langs.push_back(g.languages);
-                genres.push_back(g.overall_genre);
-                count++;
-            }
+    publisher_stats.clear();
+    auto emit_pub = [&](const std::string& key, const GroupStates& states) {
+        publisher_stats.push_back(publisher_report.finish(key, states, view));
+    };
 
-            stat.count = count;
-            stat.avg_all = sum_all / count;
-            stat.avg_recent = sum_recent / count;
-            stat.avg_price = sum_price / count;
-            stat.common_genre = most_common(genres);
-            stat.least_common_genre = least_common(genres);
-            stat.common_language = most_common(langs);
-            stat.least_common_language = least_common(langs);
+    std::vector<std::pair<std::string, int>> genre_counts;
+    auto emit_genre = [&](const std::string& key, int count) { genre_counts.emplace_back(key, count); };
 
-            local.push_back(stat);
-        }
+    top_games.clear();
+    auto take_top = [&](const RankRecord& r) {
+        float last = top_games.empty() ? r.rating : top_games.back().rating;
+        if (!takes_next(top_games_query, top_games.size(), last, r.rating)) return false;
+        top_games.push_back({r.name, r.developer, r.rating, r.price, r.release_date});
+        return true;
     };
 
-    for (unsigned int t = 0; t < threads; ++t) {
-        int start = t * chunk;
-        int end = std::min((int)devs.size(), start + chunk);
-        workers.emplace_back(work, start, end, std::ref(local_results[t]));
+    // -- Each kind is merged from its own runs or emitted from memory: spill_map() writes no
+    // run for an empty map, so one kind can have spilled while another never did
+    if (st.dev_runs.empty()) {
+        for (const auto& [k, v] : st.developers) emit_dev(k, v);
+    } else {
+        merge_runs<GroupStates>(st.dev_runs, emit_dev);
     }
+    if (st.pub_runs.empty()) {
+        for (const auto& [k, v] : st.publishers) emit_pub(k, v);
+    } else {
+        merge_runs<GroupStates>(st.pub_runs, emit_pub);
+    }
+    if (st.genre_runs.empty()) {
+        for (const auto& [k, v] : st.genres) emit_genre(k, v);
+    } else {
+        merge_runs<int>(st.genre_runs, emit_genre);
+    }
+    if (st.rank_runs.empty()) {
+        std::stable_sort(st.ranking.begin(), st.ranking.end(), rank_before);
+        for (const auto& r : st.ranking)
+            if (!take_top(r)) break;
+    } else {
+        merge_ranking_runs(st.rank_runs, take_top);
+    }
+    st = SpillState();
+    ooc_stats.unique_genres = genre_counts.size();
 
-    for (auto& w : workers) w.join();
-
-    for (const auto& chunk : local_results)
-        developer_stats.insert(developer_stats.end(), chunk.begin(), chunk.end());
-
+    print_system_requirements();
+    float top_rating = top_games.empty() ? -1.0f : top_games.front().rating;
+    std::cout << "🎮 Top Games with " << top_rating << "% rating: " << top_games.size() << " found.\n";
+    select_top_genres(genre_counts);
     std::cout << "📊 Developer stats computed: " << developer_stats.size() << "\n";
+    std::cout << "📊 Publisher stats computed: " << publisher_stats.size() << "\n";
 }
 
-void export_developer_stats(const std::string& filename = "developer_stats.csv") {
-    std::ofstream file(filename);
-    file << "developer,avg_all,avg_recent,avg_price,common_genre,least_common_genre,common_language,least_common_language\n";
+// ===================== Part 8: Benchmarking =====================
 
-    for (const auto& s : developer_stats) {
-        file << "\"" << s.developer << "\","
-             << s.avg_all << ","
-             << s.avg_recent << ","
-             << s.avg_price << ","
-             << "\"" << s.common_genre << "\","
-             << "\"" << s.least_common_genre << "\","
-             << "\"" << s.common_language << "\","
-             << "\"" << s.least_common_language << "\"\n";
-    }
+using namespace std::chrono;
 
-    file.close();
-    std::cout << "📄 Developer stats export saved to " << filename << "\n";
+// Time and log a stage
+void benchmark(const std::string& label, const std::function<void()>& func) {
+    TraceScope scope("stage", label);
+    ProfileStageScope profile(label);
+    metrics_stage_begin(label);
+    auto start = steady_clock::now();
+    PerfCounts counters = count_stage(func);
+    auto end = steady_clock::now();
+
+    long long duration = duration_cast<nanoseconds>(end - start).count();
+    metrics_stage_end(label, duration);
+    benchmark_log.push_back({label, duration, counters});
+    std::cout << "⏱️  " << label << ": " << duration / 1e6 << " ms\n";
 }
-// ===================== Part 7: Publisher-Level Stats =====================
 
-struct PublisherStats {
-    std::string publisher;
-    float avg_all = 0;
-    float avg_recent = 0;
-    float avg_price = 0;
-    std::string common_genre;
-    std::string least_common_genre;
-    std::string common_language;
-    std::string least_common_language;
-    int count = 0;
+// ===================== Part 8b: Stage Graph =====================
+// Stages declare the data they read and write; a stage is handed to the shared pool as one
+// task as soon as every producer of its inputs has finished, so independent analytics
+// overlap without a thread of their own. A finishing stage submits the dependents it
+// released; the caller runs ready stages too while it waits. Parallel work inside a stage
+// is a nested batch that its own thread helps with, so it cannot wait on another stage.
+// Inputs that no stage produces count as available from the start. Untimed stages (the
+// exports, which only render their table and queue it for the I/O thread) start as soon
+// as their producer finishes too, but stay out of the logs, the critical path and the
+// graph's elapsed time, which ends with the last timed stage.
+
+struct Stage {
+    std::string name;
+    std::vector<std::string> inputs;
+    std::vector<std::string> outputs;
+    std::function<void()> run;
+    bool timed = true;
 };
 
-std::vector<PublisherStats> publisher_stats;
-
-void compute_publisher_stats() {
-    publisher_stats.clear();
-    std::map<std::string, std::vector<SteamGame>> buckets;
-
-    for (const auto& g : structured_games)
-        if (!g.publisher.empty())
-            buckets[g.publisher].push_back(g);
-
-    std::vector<std::string> pubs;
-    for (const auto& [pub, _] : buckets)
-        pubs.push_back(pub);
-
-    unsigned int threads = std::thread::hardware_concurrency();
-    if (threads == 0) threads = 4;
-
-    int chunk = (pubs.size() + threads - 1) / threads;
-    std::vector<std::thread> workers;
-    std::vector<std::vector<PublisherStats>> local_results(threads);
-
-    auto work = [&](int start, int end, std::vector<PublisherStats>& local) {
-        for (int i = start; i < end && i < pubs.size(); ++i) {
-            const auto& pub = pubs[i];
-            const auto& games = buckets[pub];
-            if (games.empty()) continue;
-
-            PublisherStats stat;
-            stat.publisher = pub;
-            std::vector<std::string> langs, genres;
-            float sum_all = 0, sum_recent = 0, sum_price = 0;
-            int count = 0;
-
-            for (const auto& g : games) {
-                if (g.all_reviews_percent >= 0) sum_all += g.all_reviews_percent;
-                if (g.recent_reviews_percent >= 0) sum_recent += g.recent_reviews_percent;
-                if (g.original_price >= 0) sum_price += g.original_price;
-                langs.push_back(g.languages);
-                genres.push_back(g.overall_genre);
-                count++;
-            }
+struct StageTiming {
+    std::string name;
+    long long start_us = 0;   // offsets from the start of the graph
+    long long end_us = 0;
+    std::vector<size_t> deps;
+};
 
-            stat.count = count;
-            stat.avg_all = sum_all / count;
-            stat.avg_recent = sum_recent / count;
-            stat.avg_price = sum_price / count;
-            stat.common_genre = most_common(genres);
-            stat.least_common_genre = least_common(genres);
-            stat.common_language = most_common(langs);
-            stat.least_common_language = least_common(langs);
+std::vector<StageTiming> stage_log;   // timed stages of the last graph run, in declaration order
+long long stage_graph_ns = 0;         // start of the last graph run to the end of its last timed stage
+
+// -- Run the graph; returns false (after draining running stages) if it has a cycle
+bool run_stage_graph(const std::vector<Stage>& stages) {
+    size_t n = stages.size();
+    std::map<std::string, size_t> producer;
+    for (size_t i = 0; i < n; ++i)
+        for (const auto& out : stages[i].outputs) producer[out] = i;
+
+    std::vector<std::vector<size_t>> deps(n), dependents(n);
+    for (size_t i = 0; i < n; ++i) {
+        for (const auto& in : stages[i].inputs) {
+            auto it = producer.find(in);
+            if (it == producer.end() || it->second == i) continue;
+            deps[i].push_back(it->second);
+            dependents[it->second].push_back(i);
+        }
+    }
 
-            local.push_back(stat);
+    // stage_log holds the timed stages only; untimed stages produce nothing, so no timed
+    // stage depends on one
+    std::vector<size_t> log_index(n, n);
+    size_t timed = 0;
+    for (size_t i = 0; i < n; ++i)
+        if (stages[i].timed) log_index[i] = timed++;
+    stage_log.assign(timed, StageTiming());
+
+    std::vector<size_t> waiting(n);
+    std::mutex lock;   // guards waiting, done, the logs and submit() on 'graph'
+    size_t done = 0;
+    long long timed_end_ns = 0;
+    ThreadPool& pool = thread_pool();
+    TaskBatch graph;   // unlabelled: stages are timed here, not in scheduler_log
+    graph.stats.assign(pool.slots(), WorkerStats());
+    auto graph_start = steady_clock::now();
+
+    std::function<void(size_t)> submit_stage;
+    auto run_stage = [&](size_t i) {
+        ProfileStageScope profile(stages[i].name);
+        if (!stages[i].timed) {
+            stages[i].run();
+            std::lock_guard<std::mutex> guard(lock);
+            done++;
+            for (size_t d : dependents[i])
+                if (--waiting[d] == 0) submit_stage(d);
+            return;
         }
+        metrics_stage_begin(stages[i].name);
+        auto start = steady_clock::now();
+        PerfCounts counters;
+        {
+            TraceScope scope("stage", stages[i].name);
+            counters = count_stage(stages[i].run);
+        }
+        auto end = steady_clock::now();
+        metrics_stage_end(stages[i].name, duration_cast<nanoseconds>(end - start).count());
+
+        // Dependents are submitted before this task leaves the batch, so the batch
+        // cannot drain while stages are still to come
+        std::lock_guard<std::mutex> guard(lock);
+        std::vector<size_t> logged_deps;
+        for (size_t d : deps[i]) logged_deps.push_back(log_index[d]);
+        stage_log[log_index[i]] = {stages[i].name, duration_cast<microseconds>(start - graph_start).count(),
+                                   duration_cast<microseconds>(end - graph_start).count(), logged_deps};
+        timed_end_ns = std::max(timed_end_ns, (long long)duration_cast<nanoseconds>(end - graph_start).count());
+        long long ns = duration_cast<nanoseconds>(end - start).count();
+        benchmark_log.push_back({stages[i].name, ns, counters});
+        std::cout << "⏱️  " << stages[i].name << ": " << ns / 1e6 << " ms\n";
+        done++;
+        for (size_t d : dependents[i])
+            if (--waiting[d] == 0) submit_stage(d);
     };
+    submit_stage = [&](size_t i) { pool.submit([&run_stage, i] { run_stage(i); }, graph); };
 
-    for (unsigned int t = 0; t < threads; ++t) {
-        int start = t * chunk;
-        int end = std::min((int)pubs.size(), start + chunk);
-        workers.emplace_back(work, start, end, std::ref(local_results[t]));
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        for (size_t i = 0; i < n; ++i)
+            if ((waiting[i] = deps[i].size()) == 0) submit_stage(i);
     }
+    pool.wait(graph);   // stages left waiting once the batch drains are on a cycle
 
-    for (auto& w : workers) w.join();
-
-    for (const auto& chunk : local_results)
-        publisher_stats.insert(publisher_stats.end(), chunk.begin(), chunk.end());
-
-    std::cout << "📊 Publisher stats computed: " << publisher_stats.size() << "\n";
-}
-
-void export_publisher_stats(const std::string& filename = "publisher_stats.csv") {
-    std::ofstream file(filename);
-    file << "publisher,avg_all,avg_recent,avg_price,common_genre,least_common_genre,common_language,least_common_language\n";
-
-    for (const auto& s : publisher_stats) {
-        file << "\"" << s.publisher << "\","
-             << s.avg_all << ","
-             << s.avg_recent << ","
-             << s.avg_price << ","
-             << "\"" << s.common_genre << "\","
-             << "\"" << s.least_common_genre << "\","
-             << "\"" << s.common_language << "\","
-             << "\"" << s.least_common_language << "\"\n";
+    stage_graph_ns = timed_end_ns;
+    if (done < n) {
+        std::cerr << "❌ Stage graph has a dependency cycle; " << n - done << " stages never ran\n";
+        return false;
     }
-
-    file.close();
-    std::cout << "📄 Publisher stats export saved to " << filename << "\n";
+    return true;
 }
-// ===================== Part 8: Benchmarking =====================
-
-#include <chrono>
-#include <functional>
-using namespace std::chrono;
-
-struct BenchmarkEntry {
-    std::string part;
-    long long duration_ms;
-};
-
-std::vector<BenchmarkEntry> benchmark_log;
 
-// Time and log a stage
-void benchmark(const std::string& label, const std::function<void()>& func) {
-    auto start = high_resolution_clock::now();
-    func();
-    auto end = high_resolution_clock::now();
+// -- Longest chain of stage durations through the dependency edges, in run order
+std::vector<size_t> critical_path() {
+    size_t n = stage_log.size();
+    std::vector<long long> length(n, 0);
+    std::vector<size_t> via(n, n);
+    std::vector<size_t> order(n);
+    for (size_t i = 0; i < n; ++i) order[i] = i;
+    std::sort(order.begin(), order.end(), [](size_t a, size_t b) { return stage_log[a].end_us < stage_log[b].end_us; });
+
+    for (size_t i : order) {
+        for (size_t d : stage_log[i].deps)
+            if (length[d] > length[i]) { length[i] = length[d]; via[i] = d; }
+        length[i] += stage_log[i].end_us - stage_log[i].start_us;
+    }
 
-    auto duration = duration_cast<milliseconds>(end - start).count();
-    benchmark_log.push_back({label, duration});
-    std::cout << "⏱️  " << label << ": " << duration << " ms\n";
+    std::vector<size_t> path;
+    if (n == 0) return path;
+    size_t last = std::max_element(length.begin(), length.end()) - length.begin();
+    for (size_t i = last; i != n; i = via[i]) path.push_back(i);
+    std::reverse(path.begin(), path.end());
+    return path;
 }
 
 // Export summary in the same format as sequential
@@ -761,20 +2839,21 @@ void export_benchmark_summary(const std::string& filename = "benchmark_results.c
     // Section 1: Timing Summary
     file << "Timing Summary\n";
     file << "Part,Time (ms)\n";
-    long long total = 0;
+    double total = 0;
     for (const auto& entry : benchmark_log) {
-        file << entry.part << "," << entry.duration_ms << "\n";
-        if (entry.part != "Wall Clock Time") total += entry.duration_ms;
+        file << entry.part << "," << entry.duration_ns / 1e6 << "\n";
+        if (entry.part != "Wall Clock Time") total += entry.duration_ns / 1e6;
     }
     file << "Total Execution Time," << total << "\n\n";
 
     // Section 2: Performance Summary
     file << "Performance Summary\n";
     file << "Metric,Value\n";
+    size_t games = memory_budget_bytes > 0 ? ooc_stats.games : structured_games.size();
     file << "Raw Rows," << rawRows.size() << "\n";
-    file << "Total Games Processed," << structured_games.size() << "\n";
+    file << "Total Games Processed," << games << "\n";
     if (total > 0) {
-        double throughput = (double)structured_games.size() / (total / 1000.0);
+        double throughput = (double)games / (total / 1000.0);
         file << "Throughput (games/sec)," << throughput << "\n";
     }
     file << "\n";
@@ -785,8 +2864,8 @@ void export_benchmark_summary(const std::string& filename = "benchmark_results.c
 
     std::set<std::string> devs, pubs, genres;
     for (const auto& g : structured_games) {
-        if (!g.developer.empty()) devs.insert(g.developer);
-        if (!g.publisher.empty()) pubs.insert(g.publisher);
+        if (!g.developer.empty()) devs.insert(g.developer.str());
+        if (!g.publisher.empty()) pubs.insert(g.publisher.str());
         std::stringstream ss(g.overall_genre);
         std::string token;
         while (std::getline(ss, token, ',')) {
@@ -794,13 +2873,266 @@ void export_benchmark_summary(const std::string& filename = "benchmark_results.c
             if (!token.empty()) genres.insert(token);
         }
     }
-    file << "Unique Developers," << devs.size() << "\n";
-    file << "Unique Publishers," << pubs.size() << "\n";
-    file << "Unique Genres," << genres.size() << "\n";
+    if (memory_budget_bytes > 0) {
+        file << "Unique Developers," << developer_stats.size() << "\n";
+        file << "Unique Publishers," << publisher_stats.size() << "\n";
+        file << "Unique Genres," << ooc_stats.unique_genres << "\n\n";
+    } else {
+        file << "Unique Developers," << devs.size() << "\n";
+        file << "Unique Publishers," << pubs.size() << "\n";
+        file << "Unique Genres," << genres.size() << "\n\n";
+    }
+
+    // Section 4: String Pool (developer, publisher, languages, popular_tags)
+    file << "String Pool Stats\n";
+    file << "Metric,Value\n";
+    file << "Pooled Values," << string_pool.requests << "\n";
+    file << "Unique Values," << string_pool.size() << "\n";
+    file << "Logical Bytes," << string_pool.requested_bytes << "\n";
+    file << "Stored Bytes," << string_pool.stored_bytes << "\n";
+    file << "Bytes Saved," << string_pool.requested_bytes - string_pool.stored_bytes << "\n";
+    if (string_pool.stored_bytes > 0)
+        file << "Dedup Ratio," << (double)string_pool.requested_bytes / string_pool.stored_bytes << "\n";
+
+    // Section 5: Out-of-core spilling (only with --memory-budget)
+    if (memory_budget_bytes > 0) {
+        file << "\nOut-of-Core\n";
+        file << "Metric,Value\n";
+        file << "Memory Budget (bytes)," << memory_budget_bytes << "\n";
+        file << "Batches," << ooc_stats.batches << "\n";
+        file << "Runs Spilled," << ooc_stats.runs << "\n";
+        file << "Bytes Spilled," << ooc_stats.spilled_bytes << "\n";
+        file << "Peak Partial State (bytes)," << ooc_stats.peak_state_bytes << "\n";
+    }
+
+    // Section 6: Compact numeric columns (only with --compact)
+    if (use_compact_columns) {
+        file << "\nCompact Columns\n";
+        file << "Metric,Value\n";
+        file << "Float Column Bytes," << structured_games.size() * 4 * sizeof(float) << "\n";
+        file << "Compact Column Bytes," << compact_columns.bytes() << "\n";
+    }
+
+    // Section 7: Overlapped load/parse ring (only with --pipeline)
+    if (use_pipeline && memory_budget_bytes == 0) {
+        const auto& ps = pipeline_stats;
+        file << "\nLoad/Parse Pipeline\n";
+        file << "Metric,Value\n";
+        file << "Ring Capacity (batches)," << ps.capacity << "\n";
+        file << "Batch Size (rows)," << ps.batch_rows << "\n";
+        file << "Batches," << ps.batches << "\n";
+        file << "Rows," << ps.rows << "\n";
+        file << "Reader Time (ms)," << ps.read_us / 1000.0 << "\n";
+        file << "Max Queue Depth," << ps.max_depth << "\n";
+        if (ps.batches > 0)
+            file << "Mean Queue Depth," << (double)ps.depth_sum / ps.batches << "\n";
+        file << "Producer Stalls (ring full)," << ps.producer_stalls << "\n";
+        file << "Producer Stall Time (ms)," << ps.producer_stall_us / 1000.0 << "\n";
+        file << "Consumer Stalls (ring empty)," << ps.consumer_stalls << "\n";
+        file << "Consumer Stall Time (ms)," << ps.consumer_stall_us / 1000.0 << "\n";
+    }
+
+    // Section 8: Background CSV writes over the whole run so far
+    OutputStats io = async_output().snapshot();
+    if (io.files > 0) {
+        file << "\nAsync Output\n";
+        file << "Metric,Value\n";
+        file << "Files Written," << io.files << "\n";
+        file << "Bytes Written," << io.bytes << "\n";
+        file << "Write Failures," << io.failures << "\n";
+        file << "Peak Queued Files," << io.peak_queued << "\n";
+        file << "I/O Thread Write Time (ms)," << io.write_us / 1000.0 << "\n";
+        file << "Blocked on I/O (ms)," << io.blocked_us / 1000.0 << "\n";
+    }
+
+    // Section 9: Stage graph critical path
+    if (!stage_log.empty()) {
+        long long stage_sum_us = 0;
+        for (const auto& st : stage_log) stage_sum_us += st.end_us - st.start_us;
+
+        file << "\nCritical Path\n";
+        file << "Stage,Start (ms),End (ms),Duration (ms)\n";
+        long long path_us = 0;
+        for (size_t i : critical_path()) {
+            const auto& st = stage_log[i];
+            file << st.name << "," << st.start_us / 1000.0 << "," << st.end_us / 1000.0 << ","
+                 << (st.end_us - st.start_us) / 1000.0 << "\n";
+            path_us += st.end_us - st.start_us;
+        }
+        file << "Critical Path Length (ms)," << path_us / 1000.0 << "\n";
+        file << "Graph Elapsed (ms)," << stage_graph_ns / 1e6 << "\n";
+        file << "Sum of Stage Times (ms)," << stage_sum_us / 1000.0 << "\n";
+        if (stage_graph_ns > 0)
+            file << "Stage Overlap (sum/elapsed)," << stage_sum_us * 1000.0 / stage_graph_ns << "\n";
+    }
+
+    // Section 10: Work-stealing load balance per scheduled stage
+    if (!scheduler_log.empty()) {
+        file << "\nScheduler Load Balance\n";
+        file << "Stage,Tasks,Steals,Max Busy (ms),Mean Busy (ms),Imbalance (max/mean),Total Idle (ms)\n";
+        for (const auto& run : scheduler_log) {
+            long long max_busy = 0, sum_busy = 0, sum_idle = 0;
+            size_t steals = 0;
+            for (const auto& w : run.workers) {
+                max_busy = std::max(max_busy, w.busy_us);
+                sum_busy += w.busy_us;
+                sum_idle += w.idle_us;
+                steals += w.steals;
+            }
+            double mean_busy = (double)sum_busy / run.workers.size();
+            file << run.label << "," << run.tasks << "," << steals << ","
+                 << max_busy / 1000.0 << "," << mean_busy / 1000.0 << ","
+                 << (mean_busy > 0 ? max_busy / mean_busy : 1.0) << "," << sum_idle / 1000.0 << "\n";
+        }
+
+        file << "\nWorker Busy/Idle\n";
+        file << "Stage,Worker,Busy (ms),Idle (ms),Tasks,Steals\n";
+        for (const auto& run : scheduler_log)
+            for (size_t w = 0; w < run.workers.size(); ++w)
+                file << run.label << "," << w << "," << run.workers[w].busy_us / 1000.0 << ","
+                     << run.workers[w].idle_us / 1000.0 << "," << run.workers[w].tasks << ","
+                     << run.workers[w].steals << "\n";
+    }
+
+    // Section 11: Hardware counters per stage (only with --perf-counters)
+    if (perf_counters_enabled) {
+        file << "\nHardware Counters\n";
+        bool any = std::any_of(benchmark_log.begin(), benchmark_log.end(),
+                               [](const BenchmarkEntry& e) { return e.counters.valid; });
+        if (!any) {
+            file << "Status,unavailable (timing only)\n";
+        } else {
+            size_t rows = rawRows.empty() ? games : rawRows.size();
+            file << "Part,Cycles,Instructions,IPC,Cache Misses,Branch Misses,Page Faults,"
+                 << "Cache Misses/Row,Branch Misses/Row\n";
+            auto count = [&](const PerfCounts& c, int e) { return c.has(e) ? std::to_string(c.value[e]) : std::string(); };
+            auto per_row = [&](const PerfCounts& c, int e) {
+                return c.has(e) && rows > 0 ? std::to_string((double)c.value[e] / rows) : std::string();
+            };
+            for (const auto& entry : benchmark_log) {
+                const PerfCounts& c = entry.counters;
+                if (!c.valid) continue;
+                std::string ipc = c.has(PERF_CYCLES) && c.has(PERF_INSTRUCTIONS) && c.value[PERF_CYCLES] > 0
+                                      ? std::to_string((double)c.value[PERF_INSTRUCTIONS] / c.value[PERF_CYCLES])
+                                      : std::string();
+                file << entry.part << "," << count(c, PERF_CYCLES) << "," << count(c, PERF_INSTRUCTIONS) << ","
+                     << ipc << "," << count(c, PERF_CACHE_MISSES) << "," << count(c, PERF_BRANCH_MISSES) << ","
+                     << count(c, PERF_PAGE_FAULTS) << "," << per_row(c, PERF_CACHE_MISSES) << ","
+                     << per_row(c, PERF_BRANCH_MISSES) << "\n";
+            }
+        }
+    }
 
     file.close();
     std::cout << "📊 Benchmark results saved to " << filename << "\n";
 }
+
+// ===================== Part 8d: Scaling Study =====================
+// Strong scaling runs every --limits size at every --threads count. Weak scaling
+// (--weak-scaling ROWS) runs ROWS x threads rows at each count, so the work per thread
+// stays fixed. Per stage, speedup and efficiency are taken against the smallest thread
+// count (p is threads relative to it), and the Karp-Flatt metric
+// e = (1/S - 1/p) / (1 - 1/p) estimates the stage's serial fraction; an e that grows with
+// p points at parallel overhead rather than a fixed serial part. Weak scaling uses the
+// scaled speedup S = p * T(base) / T(p).
+
+int weak_rows_per_thread = 0;   // --weak-scaling ROWS; 0 = strong scaling over --limits
+
+// Stages with efficiency below this have stopped scaling
+const double SCALING_EFFICIENCY_FLOOR = 0.5;
+
+struct ScalingPoint {
+    std::string stage;
+    int input_size;
+    unsigned int threads;
+    double ms;
+    double speedup;
+    double efficiency;
+    double karp_flatt;   // NaN at the base thread count
+};
+
+// -- One series per stage (strong: per stage and input size), ordered by thread count
+std::map<std::pair<std::string, int>, std::vector<ScalingPoint>> scaling_series(bool weak) {
+    std::map<std::pair<std::string, int>, std::vector<ScalingPoint>> series;
+    for (const auto& [key, samples] : stage_samples) {
+        ScalingPoint pt{key.stage, key.input_size, key.threads, summarize(samples).median_ns / 1e6, 1.0, 1.0, NAN};
+        series[{key.stage, weak ? 0 : key.input_size}].push_back(pt);
+    }
+
+    for (auto& [id, points] : series) {
+        std::sort(points.begin(), points.end(), [](const ScalingPoint& a, const ScalingPoint& b) { return a.threads < b.threads; });
+        const ScalingPoint& base = points.front();
+        for (auto& pt : points) {
+            double p = double(pt.threads) / base.threads;
+            double ratio = pt.ms > 0 ? base.ms / pt.ms : 1.0;
+            pt.speedup = weak ? p * ratio : ratio;
+            pt.efficiency = pt.speedup / p;
+            if (p > 1 && pt.speedup > 0) pt.karp_flatt = (1.0 / pt.speedup - 1.0 / p) / (1.0 - 1.0 / p);
+        }
+    }
+    return series;
+}
+
+// -- Every point to scaling_report.csv; one line per stage (largest input for strong
+// scaling) to scaling_summary.csv and the console, earliest to stop scaling first
+void export_scaling_report(const std::string& report_file = "scaling_report.csv",
+                           const std::string& summary_file = "scaling_summary.csv") {
+    bool weak = weak_rows_per_thread > 0;
+    const char* mode = weak ? "weak" : "strong";
+    auto series = scaling_series(weak);
+
+    std::ofstream report(report_file);
+    report << "Mode,Stage,Input Size,Threads,Time (ms),Speedup,Efficiency,Karp-Flatt\n";
+    for (const auto& [id, points] : series)
+        for (const auto& pt : points) {
+            report << mode << "," << pt.stage << "," << pt.input_size << "," << pt.threads << ","
+                   << pt.ms << "," << pt.speedup << "," << pt.efficiency << ",";
+            if (!std::isnan(pt.karp_flatt)) report << pt.karp_flatt;
+            report << "\n";
+        }
+
+    struct Summary {
+        const ScalingPoint* last;
+        unsigned int stops_at;   // first thread count below the efficiency floor, 0 = never
+    };
+    std::map<std::string, Summary> by_stage;
+    for (const auto& [id, points] : series) {
+        auto found = by_stage.find(id.first);
+        if (found != by_stage.end() && found->second.last->input_size > points.back().input_size) continue;
+        Summary sum{&points.back(), 0};
+        for (const auto& pt : points)
+            if (pt.efficiency < SCALING_EFFICIENCY_FLOOR) { sum.stops_at = pt.threads; break; }
+        by_stage[id.first] = sum;
+    }
+
+    std::vector<std::pair<std::string, Summary>> order(by_stage.begin(), by_stage.end());
+    std::stable_sort(order.begin(), order.end(), [](const auto& a, const auto& b) {
+        unsigned int x = a.second.stops_at ? a.second.stops_at : UINT_MAX;
+        unsigned int y = b.second.stops_at ? b.second.stops_at : UINT_MAX;
+        return x != y ? x < y : a.second.last->efficiency < b.second.last->efficiency;
+    });
+
+    std::ofstream summary(summary_file);
+    summary << "Mode,Stage,Input Size,Threads,Speedup,Efficiency,Karp-Flatt,Stops Scaling At\n";
+    std::cout << "\n📈 " << (weak ? "Weak" : "Strong") << " scaling by stage (efficiency < "
+              << SCALING_EFFICIENCY_FLOOR * 100 << "% counts as stopped):\n";
+    for (const auto& [stage, sum] : order) {
+        const ScalingPoint& pt = *sum.last;
+        summary << mode << "," << stage << "," << pt.input_size << "," << pt.threads << ","
+                << pt.speedup << "," << pt.efficiency << ",";
+        if (!std::isnan(pt.karp_flatt)) summary << pt.karp_flatt;
+        summary << "," << (sum.stops_at ? std::to_string(sum.stops_at) : "") << "\n";
+
+        std::cout << "   " << std::left << std::setw(30) << stage << std::right
+                  << " x" << std::setw(4) << pt.threads << "  speedup " << std::setw(6) << std::fixed
+                  << std::setprecision(2) << pt.speedup << "  efficiency " << std::setw(5) << pt.efficiency
+                  << "  serial " << std::setw(5) << (std::isnan(pt.karp_flatt) ? 0.0 : pt.karp_flatt)
+                  << std::defaultfloat << std::setprecision(6)
+                  << (sum.stops_at ? "  ⚠️ stops at " + std::to_string(sum.stops_at) + " threads" : "") << "\n";
+    }
+    std::cout << "📄 Scaling report saved to " << report_file << " and " << summary_file << "\n";
+}
+
 long long now_ms() {
     return std::chrono::duration_cast<std::chrono::milliseconds>(
         std::chrono::steady_clock::now().time_since_epoch()
@@ -875,81 +3207,329 @@ long long now_ms() {
     return 0;
 }*/
 
-int main() {
-    show_cpu_info();  // From Part 1
+// Command-line flags
+std::string db_path = "steam.db";   // --db PATH, e.g. a generate_steam_data.py database
+std::vector<int> size_limits = {1000, 2000, 5000, 10000, 20000, 30000, 40000};   // --limits
+bool export_results = false;        // --export: write every result CSV for the last run
+bool export_this_run = false;       // the run in progress is the last measured run and --export is set
+
+std::vector<unsigned int> thread_axis;   // --threads N[,N...]; empty = one run at worker_count()
+
+void print_usage() {
+    std::cerr << "Usage: parallel [--compact] [--memory-budget MB] [--spill-dir DIR]\n"
+              << "                [--top-k K] [--top-ties keep|exact] [--grain ROWS]\n"
+              << "                [--pipeline] [--ring-capacity BATCHES]\n"
+              << "                [--threads N[,N...]] [--cpus LIST] [--histogram local|atomic|mutex]\n"
+              << "                [--warmup N] [--reps N] [--db PATH] [--limits N[,N...]]\n"
+              << "                [--weak-scaling ROWS] [--perf-counters] [--trace] [--export]\n"
+              << "                [--metrics-file PATH] [--metrics-interval MS]\n"
+              << "                [--profile PATH] [--profile-hz HZ]\n";
+}
 
-    std::vector<int> limits = {1000, 2000, 5000, 10000, 20000, 30000, 40000};
-    std::ofstream log_file("size_vs_time_log.csv");
-    log_file << "Version,Input Size,Execution Time (ms),Wall Clock Time (ms)\n";
+// -- A flag value that does not parse is a usage error, not an exception
+bool bad_value(const std::string& flag, const std::string& value) {
+    std::cerr << "❌ Bad value for " << flag << ": " << value << "\n";
+    print_usage();
+    return false;
+}
+
+bool parse_args(int argc, char* argv[]) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--compact") {
+            use_compact_columns = true;
+        } else if (arg == "--memory-budget" && i + 1 < argc) {
+            size_t mb = 0;
+            if (!parse_count(argv[++i], mb) || mb > SIZE_MAX / (1024 * 1024)) return bad_value(arg, argv[i]);
+            memory_budget_bytes = mb * 1024 * 1024;
+        } else if (arg == "--threads" && i + 1 < argc) {
+            thread_axis.clear();
+            for (int n : parse_int_list(argv[++i]))
+                if (n > 0) thread_axis.push_back(static_cast<unsigned int>(n));
+            if (thread_axis.empty()) {
+                std::cerr << "❌ Bad thread count list: " << argv[i] << "\n";
+                return false;
+            }
+        } else if (arg == "--db" && i + 1 < argc) {
+            db_path = argv[++i];
+        } else if (arg == "--limits" && i + 1 < argc) {
+            size_limits = parse_size_list(argv[++i]);
+            if (size_limits.empty()) {
+                std::cerr << "❌ Bad size list: " << argv[i] << "\n";
+                return false;
+            }
+        } else if (arg == "--warmup" && i + 1 < argc) {
+            if (!parse_count(argv[++i], warmup_runs)) return bad_value(arg, argv[i]);
+        } else if (arg == "--reps" && i + 1 < argc) {
+            if (!parse_count(argv[++i], measured_runs) || measured_runs == 0) return bad_value(arg, argv[i]);
+        } else if (arg == "--cpus" && i + 1 < argc) {
+            cpu_list = parse_int_list(argv[++i]);
+            if (cpu_list.empty()) {
+                std::cerr << "❌ Bad CPU list: " << argv[i] << "\n";
+                return false;
+            }
+        } else if (arg == "--histogram" && i + 1 < argc) {
+            std::string mode = argv[++i];
+            if (mode == "local") histogram_mode = HistogramMode::ThreadLocal;
+            else if (mode == "atomic") histogram_mode = HistogramMode::Atomic;
+            else if (mode == "mutex") histogram_mode = HistogramMode::Mutex;
+            else return bad_value(arg, mode);
+        } else if (arg == "--trace") {
+            trace_enabled = true;
+        } else if (arg == "--perf-counters") {
+            perf_counters_enabled = true;
+        } else if (arg == "--export") {
+            export_results = true;
+        } else if (arg == "--weak-scaling" && i + 1 < argc) {
+            if (!parse_count(argv[++i], weak_rows_per_thread)) return bad_value(arg, argv[i]);
+        } else if (arg == "--metrics-file" && i + 1 < argc) {
+            metrics_path = argv[++i];
+        } else if (arg == "--metrics-interval" && i + 1 < argc) {
+            if (!parse_count(argv[++i], metrics_interval_ms)) return bad_value(arg, argv[i]);
+            metrics_interval_ms = std::max(10LL, metrics_interval_ms);
+        } else if (arg == "--profile" && i + 1 < argc) {
+            profile_path = argv[++i];
+        } else if (arg == "--profile-hz" && i + 1 < argc) {
+            if (!parse_count(argv[++i], profile_hz) || profile_hz == 0) return bad_value(arg, argv[i]);
+        } else if (arg == "--pipeline") {
+            use_pipeline = true;
+        } else if (arg == "--ring-capacity" && i + 1 < argc) {
+            if (!parse_count(argv[++i], ring_capacity) || ring_capacity == 0) return bad_value(arg, argv[i]);
+        } else if (arg == "--grain" && i + 1 < argc) {
+            if (!parse_count(argv[++i], grain_override)) return bad_value(arg, argv[i]);
+        } else if (arg == "--spill-dir" && i + 1 < argc) {
+            spill_dir = argv[++i];
+        } else if (arg == "--top-k" && i + 1 < argc) {
+            if (!parse_count(argv[++i], top_games_query.k) || top_games_query.k == 0) return bad_value(arg, argv[i]);
+        } else if (arg == "--top-ties" && i + 1 < argc) {
+            std::string policy = argv[++i];
+            if (policy == "keep") top_games_query.ties = TiePolicy::KeepTies;
+            else if (policy == "exact") top_games_query.ties = TiePolicy::Exact;
+            else return bad_value(arg, policy);
+        } else {
+            std::cerr << "❌ Unknown option: " << arg << "\n";
+            print_usage();
+            return false;
+        }
+    }
 
-    for (int limit : limits) {
-        benchmark_log.clear();
-        std::cout << "\n📊 Running benchmark with LIMIT = " << limit << " rows...\n";
+    // Weak scaling reads ROWS x threads rows; the largest product must still be an int limit
+    if (weak_rows_per_thread > 0) {
+        unsigned int most = thread_axis.empty() ? worker_count()
+                                                : *std::max_element(thread_axis.begin(), thread_axis.end());
+        if (static_cast<long long>(weak_rows_per_thread) * most > INT_MAX) {
+            std::cerr << "❌ --weak-scaling " << weak_rows_per_thread << " x " << most
+                      << " threads exceeds " << INT_MAX << " rows\n";
+            return false;
+        }
+    }
+    return true;
+}
 
-        // Open DB
-        if (sqlite3_open("steam.db", &db) != SQLITE_OK) {
-            std::cerr << "❌ Failed to open database.\n";
-            return 1;
+// -- One full run at 'limit' rows; fills benchmark_log, stage_log and scheduler_log.
+// Execution time is the graph's elapsed time, since stages overlap (the sum of stages
+// for the sequential out-of-core path). Returns false if the DB won't open or the graph is bad.
+bool run_pipeline(int limit, long long& exec_ns, long long& wall_ns) {
+    benchmark_log.clear();
+    scheduler_log.clear();
+    stage_log.clear();
+    trace_reset();
+
+    if (sqlite3_open(db_path.c_str(), &db) != SQLITE_OK) {
+        std::cerr << "❌ Failed to open database.\n";
+        return false;
+    }
+    auto wall_start = steady_clock::now();
+
+    if (memory_budget_bytes > 0) {
+        // Stages run one after another, in list order
+        std::vector<Stage> stages = {
+            {"out_of_core_stream", {}, {"runs"}, [limit] { stream_out_of_core(limit); }},
+            {"out_of_core_merge", {"runs"}, {}, [] { merge_out_of_core(); }},
+        };
+        metrics_run_begin(limit, thread_pool().size(), stages.size());
+        for (const auto& stage : stages)
+            benchmark(stage.name, stage.run);
+        exec_ns = 0;
+        for (const auto& entry : benchmark_log)
+            exec_ns += entry.duration_ns;
+
+        // Merged tables go to the I/O thread after the timed stages
+        if (export_this_run) {
+            std::cout << "⚠️  Out-of-core runs keep no rows in memory; skipping the raw and formatted exports\n";
+            export_requirements_debug();
+            export_top_games();
+            export_top_genres();
+            export_developer_stats();
+            export_publisher_stats();
+        }
+    } else {
+        // Stages run as soon as their inputs exist. In the run that exports, each table is
+        // queued for the I/O thread as soon as its producer finishes, by an untimed stage,
+        // so the files are written while the rest of the graph computes and the timed
+        // graph holds the same work as Sequential's sweep
+        std::vector<Stage> stages = {
+            {"load_raw_rows", {}, {"raw_rows"}, [limit] {
+                TraceScope scope("sqlite", "SELECT steam_games");
+                std::string query = "SELECT * FROM steam_games LIMIT " + std::to_string(limit) + ";";
+                sqlite3_stmt* stmt;
+                if (sqlite3_prepare_v2(db, query.c_str(), -1, &stmt, nullptr) != SQLITE_OK) {
+                    std::cerr << "❌ Failed SELECT\n";
+                    return;
+                }
+
+                rawRows.clear();
+                while (sqlite3_step(stmt) == SQLITE_ROW) {
+                    rawRows.push_back(read_raw_row(stmt));
+                    live_metrics.rows_ingested.fetch_add(1, std::memory_order_relaxed);
+                    if (rawRows.size() >= limit) break;
+                }
+                sqlite3_finalize(stmt);
+            }},
+            {"format_all_games", {"raw_rows"}, {"games"}, [] { format_all_games(); }},
+            {"analyze_system_requirements", {"games"}, {"requirements"}, [] { analyze_system_requirements(); }},
+            {"compute_top_games", {"games", "columns"}, {"top_games"}, [] { compute_top_games(); }},
+            {"compute_top_genres", {"games"}, {"top_genres"}, [] { compute_top_genres(); }},
+            {"compute_developer_stats", {"games", "columns"}, {"developer_stats"}, [] { compute_developer_stats(); }},
+            {"compute_publisher_stats", {"games", "columns"}, {"publisher_stats"}, [] { compute_publisher_stats(); }},
+        };
+        if (use_pipeline) {
+            // One stage reads and parses; later stages see the same outputs as before
+            stages.erase(stages.begin(), stages.begin() + 2);
+            stages.insert(stages.begin(), Stage{"load_and_format", {}, {"raw_rows", "games"},
+                                                [limit] { load_and_format_pipelined(limit); }});
+        }
+        if (use_compact_columns)
+            stages.push_back({"build_compact_columns", {"games"}, {"columns"}, [] { build_compact_columns(); }});
+        size_t timed_stages = stages.size();
+        if (export_this_run) {
+            std::vector<Stage> exports = {
+                {"export_raw_debug", {"raw_rows"}, {}, [] { export_raw_debug(); }, false},
+                {"export_structured_debug", {"games"}, {}, [] { export_structured_debug(); }, false},
+                {"export_requirements_debug", {"requirements"}, {}, [] { export_requirements_debug(); }, false},
+                {"export_top_games", {"top_games"}, {}, [] { export_top_games(); }, false},
+                {"export_top_genres", {"top_genres"}, {}, [] { export_top_genres(); }, false},
+                {"export_developer_stats", {"developer_stats"}, {}, [] { export_developer_stats(); }, false},
+                {"export_publisher_stats", {"publisher_stats"}, {}, [] { export_publisher_stats(); }, false},
+            };
+            stages.insert(stages.end(), exports.begin(), exports.end());
         }
 
-        long long wall_start = now_ms();
+        metrics_run_begin(limit, thread_pool().size(), timed_stages);
+        bool ok = run_stage_graph(stages);
+        exec_ns = stage_graph_ns;
+        if (!ok) {
+            sqlite3_close(db);
+            return false;
+        }
+    }
 
-        // Load limited rows
-        benchmark("load_raw_rows", [limit] {
-            std::string query = "SELECT * FROM steam_games LIMIT " + std::to_string(limit) + ";";
-            sqlite3_stmt* stmt;
-            if (sqlite3_prepare_v2(db, query.c_str(), -1, &stmt, nullptr) != SQLITE_OK) {
-                std::cerr << "❌ Failed SELECT\n";
-                return;
-            }
+    wall_ns = duration_cast<nanoseconds>(steady_clock::now() - wall_start).count();
+    sqlite3_close(db);
+    return true;
+}
 
-            rawRows.clear();
-            while (sqlite3_step(stmt) == SQLITE_ROW) {
-                RawSteamRow row;
-                row.url = get_text(stmt, 0);
-                row.types = get_text(stmt, 1);
-                row.name = get_text(stmt, 2);
-                row.desc_snippet = get_text(stmt, 3);
-                row.recent_reviews = get_text(stmt, 4);
-                row.all_reviews = get_text(stmt, 5);
-                row.release_date = get_text(stmt, 6);
-                row.developer = get_text(stmt, 7);
-                row.publisher = get_text(stmt, 8);
-                row.popular_tags = get_text(stmt, 9);
-                row.game_details = get_text(stmt, 10);
-                row.languages = get_text(stmt, 11);
-                row.achievements = get_text(stmt, 12);
-                row.genre = get_text(stmt, 13);
-                row.game_description = get_text(stmt, 14);
-                row.mature_content = get_text(stmt, 15);
-                row.minimum_requirements = get_text(stmt, 16);
-                row.recommended_requirements = get_text(stmt, 17);
-                row.original_price = get_text(stmt, 18);
-                row.discount_price = get_text(stmt, 19);
-                rawRows.push_back(row);
-                if (rawRows.size() >= limit) break;
-            }
-            sqlite3_finalize(stmt);
-        });
+// -- Strong scaling: fixed input size, speedup and efficiency against the first thread count
+void export_strong_scaling(const std::map<int, std::vector<std::pair<unsigned int, long long>>>& runs,
+                           const std::string& filename = "strong_scaling_log.csv") {
+    std::ofstream file(filename);
+    file << "Input Size,Threads,Execution Time (ms),Speedup,Efficiency\n";
+    for (const auto& [limit, points] : runs) {
+        unsigned int base_threads = points.front().first;
+        long long base_us = points.front().second;
+        for (const auto& [threads, us] : points) {
+            double speedup = us > 0 ? (double)base_us / us : 1.0;
+            double efficiency = speedup * base_threads / threads;
+            file << limit << "," << threads << "," << us / 1000.0 << "," << speedup << "," << efficiency << "\n";
+        }
+    }
+    std::cout << "📄 Strong scaling table saved to " << filename << "\n";
+}
 
-        benchmark("format_all_games", [] { format_all_games(); });
-        benchmark("analyze_system_requirements", [] { analyze_system_requirements(); });
-        benchmark("compute_top_games", [] { compute_top_games(); });
-        benchmark("compute_top_genres", [] { compute_top_genres(); });
-        benchmark("compute_developer_stats", [] { compute_developer_stats(); });
-        benchmark("compute_publisher_stats", [] { compute_publisher_stats(); });
+int main(int argc, char* argv[]) {
+    if (!parse_args(argc, argv)) return 1;
+    if (!cpu_list.empty() && !pin_process(cpu_list)) {
+        std::cerr << "❌ Could not restrict the process to the requested CPUs.\n";
+        return 1;
+    }
+    if (thread_axis.empty()) thread_axis.push_back(worker_count());
+    trace_thread_name("main");
+    show_cpu_info();  // From Part 1
+    if (!cpu_list.empty()) std::cout << "📌 Workers pinned round-robin to " << cpu_list.size() << " CPUs\n";
+    MetricsReporter metrics;   // rewrites --metrics-file until main returns
+    if (!profile_path.empty()) {
+        if (start_profiler()) {
+            std::cout << "🔥 Sampling stacks at " << profile_hz << " Hz of CPU time\n";
+        } else {
+            std::cerr << "⚠️  Could not start the SIGPROF profiler (Linux only); running without it\n";
+            profile_path.clear();
+        }
+    }
 
-        long long wall_end = now_ms();
-        long long exec_time = 0;
-        for (const auto& entry : benchmark_log)
-            exec_time += entry.duration_ms;
+    std::ofstream log_file("size_vs_time_log.csv");
+    log_file << "Version,Input Size,Execution Time (ms),Wall Clock Time (ms)\n";
+    std::ofstream genre_log("genre_scaling_log.csv");
+    genre_log << "Input Size,Threads,Genre Histogram (us),Speedup\n";
+    std::ofstream histogram_log("histogram_variants_log.csv");
+    histogram_log << "Input Size,Histogram,Variant,Threads,Time (us),Speedup\n";
+    std::map<int, std::vector<std::pair<unsigned int, long long>>> scaling_runs;   // size -> (threads, us)
+    unsigned int max_threads = *std::max_element(thread_axis.begin(), thread_axis.end());
+
+    // Thread-count axis outside the size sweep; the pool is rebuilt once per count,
+    // outside every timed stage
+    for (unsigned int threads : thread_axis) {
+        restart_thread_pool(threads);
+        std::cout << "\n🧵 Running with " << threads << " worker threads\n";
+        std::string version = memory_budget_bytes > 0 ? "Parallel (out-of-core)"
+                            : use_pipeline            ? "Parallel (pipelined)"
+                                                      : "Parallel";
+        if (thread_axis.size() > 1) version += " x" + std::to_string(threads);
+
+        // Weak scaling keeps the rows per thread fixed instead of sweeping --limits
+        std::vector<int> limits = size_limits;
+        if (weak_rows_per_thread > 0)
+            limits = {static_cast<int>(static_cast<long long>(weak_rows_per_thread) * threads)};
+
+        for (int limit : limits) {
+            std::cout << "\n📊 Running benchmark with LIMIT = " << limit << " rows ("
+                      << warmup_runs << " warmup + " << measured_runs << " measured runs)...\n";
+
+            for (int run = 0; run < warmup_runs + measured_runs; ++run) {
+                long long exec_ns = 0, wall_ns = 0;
+                export_this_run = export_results && threads == thread_axis.back() && limit == limits.back() &&
+                                  run == warmup_runs + measured_runs - 1;
+                if (!run_pipeline(limit, exec_ns, wall_ns)) return 1;
+                if (run >= warmup_runs) record_run(limit, threads, exec_ns, wall_ns);
+            }
 
-        log_file << "Parallel," << limit << "," << exec_time << "," << (wall_end - wall_start) << "\n";
-        sqlite3_close(db);
+            // Medians over the measured runs
+            double exec_ms = median_ms({"Execution Time", limit, threads});
+            log_file << version << "," << limit << "," << exec_ms << ","
+                     << median_ms({"Wall Clock Time", limit, threads}) << "\n";
+            scaling_runs[limit].push_back({threads, static_cast<long long>(exec_ms * 1000)});
+            if (threads == max_threads && memory_budget_bytes == 0) {   // outside the timed region
+                ProfileStageScope profile("genre_scaling_logs");
+                log_genre_scaling(limit, genre_log);
+                log_histogram_variants(limit, histogram_log);
+            }
+        }
     }
 
     log_file.close();
-    std::cout << "📄 Logged results to size_vs_time_log.csv\n";
+    genre_log.close();
+    histogram_log.close();
+    std::cout << "📄 Logged results to size_vs_time_log.csv, genre_scaling_log.csv and histogram_variants_log.csv\n";
+    if (weak_rows_per_thread == 0) export_strong_scaling(scaling_runs);
+    if (thread_axis.size() > 1) export_scaling_report();
+    export_benchmark_stats("parallel");
+    if (!profile_path.empty()) export_profile();
+
+    // The last run's exports were queued while it computed; wait for them once, before the summary
+    async_output().drain();
+    std::cout << "💾 CSV exports written (" << async_output().snapshot().blocked_us / 1000.0 << " ms blocked on I/O)\n";
+
+    // Summary and trace reflect the last (largest) run
+    export_benchmark_summary();
+    export_trace();
     return 0;
 }
-
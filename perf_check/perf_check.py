@@ -0,0 +1,181 @@
+import argparse
+import json
+import os
+import platform
+import shlex
+import subprocess
+import sys
+import tempfile
+
+# Performance regression gate: runs the benchmark harness (--warmup/--reps, which writes
+# benchmark_stats.json) of Sequential and/or parallel on a fixed synthetic dataset and
+# compares every stage's median against a checked-in baseline. Fails when a stage is slower
+# than the baseline by more than --threshold (and by more than --min-delta-ms, so sub-ms
+# stages do not flap), or when a baseline stage no longer runs. Fully offline: the dataset comes from generate_steam_data.py.
+#   python perf_check.py --seq ../build/Sequential --par ../build/parallel
+#   python perf_check.py --par ../build/parallel --threshold 0.10 --stage-threshold format_all_games=0.05
+#   python perf_check.py --seq ... --par ... --update          (record a new baseline)
+# Baselines are only comparable on the machine that recorded them; re-record after moving.
+# Exit code 0 = no regression, 1 = regression or missing stage, 2 = a program or setup step failed.
+
+# === Settings ===
+here = os.path.dirname(os.path.abspath(__file__))
+parser = argparse.ArgumentParser(description="Compare benchmark stage timings against a stored baseline.")
+parser.add_argument("--seq", default=None, help="Sequential executable")
+parser.add_argument("--par", default=None, help="parallel executable")
+parser.add_argument("--baseline", default=os.path.join(here, "perf_baseline.json"), help="baseline JSON")
+parser.add_argument("--update", action="store_true", help="write this run as the new baseline instead of checking")
+parser.add_argument("--rows", type=int, default=20000, help="synthetic rows (recorded in the baseline)")
+parser.add_argument("--seed", type=int, default=42, help="generator seed (recorded in the baseline)")
+parser.add_argument("--warmup", type=int, default=1, help="warmup runs per program")
+parser.add_argument("--reps", type=int, default=5, help="measured runs per program")
+parser.add_argument("--threads", type=int, default=None,
+                    help="parallel worker count (default: the baseline's, else the CPU count)")
+parser.add_argument("--threshold", type=float, default=0.25, help="allowed slowdown per stage, as a fraction")
+parser.add_argument("--stage-threshold", action="append", default=[], metavar="STAGE=FRACTION",
+                    help="override --threshold for one stage (repeatable)")
+parser.add_argument("--min-delta-ms", type=float, default=5.0, help="slowdowns below this many ms never fail")
+parser.add_argument("--seq-args", default="", help="extra Sequential flags, e.g. --seq-args=\"--compact\"")
+parser.add_argument("--par-args", default="", help="extra parallel flags, e.g. --par-args=\"--pipeline\"")
+parser.add_argument("--work-dir", default=None, help="keep the dataset and run directories here")
+args = parser.parse_args()
+
+generator = os.path.join(here, "..", "parallel_final", "parallel_final", "generate_steam_data.py")
+
+
+def host_info():
+    return {"machine": platform.machine(), "system": platform.system(), "cpus": os.cpu_count()}
+
+
+def load_baseline(path):
+    if not os.path.exists(path):
+        return None
+    with open(path, encoding="utf-8") as f:
+        return json.load(f)
+
+
+def stage_thresholds():
+    overrides = {}
+    for item in args.stage_threshold:
+        stage, _, value = item.partition("=")
+        try:
+            overrides[stage] = float(value)
+        except ValueError:
+            print(f"❌ Bad --stage-threshold '{item}' (expected STAGE=FRACTION)")
+            sys.exit(2)
+    return overrides
+
+
+def run_benchmark(label, exe, extra, db, out_dir):
+    """Run one program's benchmark harness; returns its benchmark_stats.json results."""
+    os.makedirs(out_dir, exist_ok=True)
+    stats_file = os.path.join(out_dir, "benchmark_stats.json")
+    if os.path.exists(stats_file):
+        os.remove(stats_file)
+    cmd = [os.path.abspath(exe), "--db", os.path.abspath(db), "--limits", str(args.rows),
+           "--warmup", str(args.warmup), "--reps", str(args.reps)] + extra
+    print(f"⚙️ Running {label}: {' '.join(cmd[1:])}")
+    with open(os.path.join(out_dir, "run.log"), "w", encoding="utf-8") as log:
+        result = subprocess.run(cmd, cwd=out_dir, stdout=log, stderr=subprocess.STDOUT)
+    if result.returncode != 0 or not os.path.exists(stats_file):
+        print(f"❌ {label} failed (exit code {result.returncode}); see {os.path.join(out_dir, 'run.log')}")
+        sys.exit(2)
+    with open(stats_file, encoding="utf-8") as f:
+        return json.load(f)["results"]
+
+
+# === Step 1: Check the baseline matches this run's setup ===
+if not args.seq and not args.par:
+    print("❌ Nothing to check: pass --seq and/or --par.")
+    sys.exit(2)
+baseline = None if args.update else load_baseline(args.baseline)
+if not args.update:
+    if baseline is None:
+        print(f"❌ No baseline at '{args.baseline}'; record one with --update.")
+        sys.exit(2)
+    dataset = baseline.get("dataset", {})
+    if dataset != {"rows": args.rows, "seed": args.seed}:
+        print(f"❌ Baseline was recorded on {dataset}, not rows={args.rows} seed={args.seed}.")
+        sys.exit(2)
+    if baseline.get("host") != host_info():
+        print(f"⚠️  Baseline host {baseline.get('host')} differs from this one {host_info()}; timings may not compare.")
+
+threads = args.threads or (baseline or {}).get("threads") or os.cpu_count() or 1
+
+# === Step 2: Generate the fixed dataset once ===
+work_dir = os.path.abspath(args.work_dir) if args.work_dir else tempfile.mkdtemp(prefix="steam_perf_")
+os.makedirs(work_dir, exist_ok=True)
+db = os.path.join(work_dir, f"steam_synthetic_{args.rows}_{args.seed}.db")
+if not os.path.exists(db):
+    gen = subprocess.run([sys.executable, generator, "--rows", str(args.rows), "--seed", str(args.seed), "--out", db])
+    if gen.returncode != 0:
+        print("❌ Could not generate the synthetic database.")
+        sys.exit(2)
+
+# === Step 3: Run the benchmark harness of each program ===
+current = {}
+if args.seq:
+    current["sequential"] = run_benchmark("Sequential", args.seq, shlex.split(args.seq_args), db,
+                                          os.path.join(work_dir, "sequential"))
+if args.par:
+    current["parallel"] = run_benchmark("parallel", args.par, ["--threads", str(threads)] + shlex.split(args.par_args),
+                                        db, os.path.join(work_dir, "parallel"))
+
+if args.update:
+    record = {
+        "dataset": {"rows": args.rows, "seed": args.seed},
+        "host": host_info(),
+        "threads": threads,
+        "warmup_runs": args.warmup,
+        "measured_runs": args.reps,
+        "programs": {program: {r["stage"]: r["median_ns"] for r in results} for program, results in current.items()},
+    }
+    old = load_baseline(args.baseline)
+    if old and old.get("dataset") == record["dataset"]:   # keep the program that was not re-run
+        for program, stages in old.get("programs", {}).items():
+            record["programs"].setdefault(program, stages)
+    with open(args.baseline, "w", encoding="utf-8") as f:
+        json.dump(record, f, indent=2, sort_keys=True)
+        f.write("\n")
+    print(f"✅ Baseline saved to '{args.baseline}'")
+    sys.exit(0)
+
+# === Step 4: Per-stage delta table ===
+overrides = stage_thresholds()
+regressions = 0
+missing = 0
+print(f"\n{'Program':<11} {'Stage':<32} {'Baseline ms':>12} {'Current ms':>12} {'Delta':>9}  Status")
+for program, results in current.items():
+    base_stages = baseline.get("programs", {}).get(program)
+    if base_stages is None:
+        print(f"⚠️  No {program} stages in the baseline; record them with --update.")
+        continue
+    seen = set()
+    for r in sorted(results, key=lambda r: r["stage"]):
+        stage, now_ns = r["stage"], r["median_ns"]
+        seen.add(stage)
+        if stage not in base_stages:
+            print(f"{program:<11} {stage:<32} {'-':>12} {now_ns / 1e6:>12.3f} {'-':>9}  🆕 new stage")
+            continue
+        base_ns = base_stages[stage]
+        delta = (now_ns - base_ns) / base_ns if base_ns > 0 else 0.0
+        limit = overrides.get(stage, args.threshold)
+        if delta > limit and (now_ns - base_ns) / 1e6 > args.min_delta_ms:
+            status = f"❌ REGRESSION (> {limit:+.0%})"
+            regressions += 1
+        elif delta < -limit and (base_ns - now_ns) / 1e6 > args.min_delta_ms:
+            status = "🚀 faster"
+        else:
+            status = "✅ ok"
+        print(f"{program:<11} {stage:<32} {base_ns / 1e6:>12.3f} {now_ns / 1e6:>12.3f} {delta:>+8.1%}  {status}")
+    for stage in sorted(set(base_stages) - seen):
+        print(f"{program:<11} {stage:<32} {base_stages[stage] / 1e6:>12.3f} {'-':>12} {'-':>9}  ❌ MISSING")
+        missing += 1
+
+if missing:   # a renamed or dropped stage would otherwise pass unchecked; re-record with --update
+    print(f"\n❌ {missing} baseline stage(s) did not run; re-record the baseline with --update if intended.")
+if regressions:
+    print(f"\n❌ {regressions} stage(s) regressed beyond the threshold.")
+if missing or regressions:
+    sys.exit(1)
+print("\n✅ No stage regressed beyond the threshold.")
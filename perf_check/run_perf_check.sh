@@ -0,0 +1,16 @@
+#!/bin/sh
+# perf-check: build both programs against the system SQLite and compare their stage
+# timings with perf_baseline.json. Extra arguments go to perf_check.py, e.g.
+#   ./run_perf_check.sh --threshold 0.10
+#   ./run_perf_check.sh --update          # record a new baseline on this machine
+set -e
+cd "$(dirname "$0")"
+BUILD_DIR=${BUILD_DIR:-perf_build}
+mkdir -p "$BUILD_DIR/bin"
+
+echo "⚙️ Compiling Sequential.cpp and parallel.cpp with g++..."
+g++ -std=c++17 -O2 ../sequential_final/sequential_final/Sequential.cpp -lsqlite3 -lpthread -o "$BUILD_DIR/bin/Sequential"
+g++ -std=c++17 -O2 ../parallel_final/parallel_final/parallel.cpp -lsqlite3 -lpthread -o "$BUILD_DIR/bin/parallel"
+echo "✅ Compilation successful!"
+
+exec python3 perf_check.py --seq "$BUILD_DIR/bin/Sequential" --par "$BUILD_DIR/bin/parallel" --work-dir "$BUILD_DIR" "$@"
@@ -7,7 +7,11 @@
 #include <set>
 #include <sstream>
 #include <algorithm>
+#ifdef _WIN32
 #include <windows.h>
+#else
+#include <sched.h>
+#endif
 #include <sqlite3.h>
 #include <regex>
 #include <vector>
@@ -15,41 +19,75 @@
 #include <algorithm>
 #include <sstream>
 #include <unordered_map>
+#include <deque>
+#include <string_view>
+#include <cstdint>
+#include <cmath>
+#include <array>
+#include <chrono>
+#include <functional>
+#include <tuple>
+#include "../../common/steam_common.h"
+#include "../../common/steam_kernels.h"
 
 using namespace std;
 
-// Lock program to 1 CPU core (sequential behavior)
-void lock_to_one_cpu() {
-    HANDLE process = GetCurrentProcess();
-    DWORD_PTR mask = 1;
-    SetProcessAffinityMask(process, mask);
-    cout << "⚙️  Running on a single core..." << endl;
+// Baseline parsing kernels; kernel_bench times them against parallel.cpp's
+using seq_kernels::escape_csv;
+using seq_kernels::genre_tokens;
+using seq_kernels::join_genres;
+using seq_kernels::extract_review_percent;
+using seq_kernels::parse_price;
+using seq_kernels::extract_ram;
+using seq_kernels::extract_storage;
+using seq_kernels::extract_line;
+using seq_kernels::parse_spec_block;
+
+// ===================== CPU Affinity =====================
+// Thin layer over SetProcessAffinityMask (Windows) and sched_setaffinity (Linux)
+
+std::vector<int> cpu_list;   // --cpus LIST; the first entry is the core we run on
+
+// CPUs this process may currently run on
+std::vector<int> allowed_cpus() {
+    std::vector<int> cpus;
+#ifdef _WIN32
+    DWORD_PTR process_mask, system_mask;
+    if (GetProcessAffinityMask(GetCurrentProcess(), &process_mask, &system_mask))
+        for (int c = 0; c < 64; ++c)
+            if (process_mask & (DWORD_PTR(1) << c)) cpus.push_back(c);
+#else
+    cpu_set_t set;
+    if (sched_getaffinity(0, sizeof(set), &set) == 0)
+        for (int c = 0; c < CPU_SETSIZE; ++c)
+            if (CPU_ISSET(c, &set)) cpus.push_back(c);
+#endif
+    return cpus;
 }
 
-// Struct to hold raw database rows
-struct RawSteamRow {
-    std::string url;
-    std::string types;
-    std::string name;
-    std::string desc_snippet;
-    std::string recent_reviews;
-    std::string all_reviews;
-    std::string release_date;
-    std::string developer;
-    std::string publisher;
-    std::string popular_tags;
-    std::string game_details;
-    std::string languages;
-    std::string achievements;
-    std::string genre;
-    std::string game_description;
-    std::string mature_content;
-    std::string minimum_requirements;
-    std::string recommended_requirements;
-    std::string original_price;
-    std::string discount_price;
-};
+// Restrict the process to 'cpus'; call before any threads are started
+bool pin_process(const std::vector<int>& cpus) {
+#ifdef _WIN32
+    DWORD_PTR mask = 0;
+    for (int c : cpus) mask |= DWORD_PTR(1) << c;
+    return SetProcessAffinityMask(GetCurrentProcess(), mask) != 0;
+#else
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (int c : cpus) CPU_SET(c, &set);
+    return sched_setaffinity(0, sizeof(set), &set) == 0;
+#endif
+}
 
+// Lock program to 1 CPU core (sequential behavior)
+void lock_to_one_cpu() {
+    std::vector<int> cpus = cpu_list.empty() ? allowed_cpus() : cpu_list;
+    if (cpus.empty() || !pin_process({cpus[0]})) {
+        cerr << "⚠️  Could not pin to a single core; timings may spread across cores" << endl;
+        return;
+    }
+    cout << "⚙️  Running on a single core (CPU " << cpus[0] << ")..." << endl;
+}
 
 // Part 2: SQLite Connection + Raw Row Loader
 
@@ -59,12 +97,6 @@ sqlite3* db;
 // Vector to hold all imported rows
 vector<RawSteamRow> rawRows;
 
-// Safe string reader to prevent null crashes
-string get_text(sqlite3_stmt* stmt, int col) {
-    const unsigned char* val = sqlite3_column_text(stmt, col);
-    return val ? reinterpret_cast<const char*>(val) : "";
-}
-
 // Function to load all rows from the 'steam_games' table
 bool load_raw_rows() {
     string query = "SELECT * FROM steam_games;";
@@ -76,29 +108,7 @@ bool load_raw_rows() {
     }
 
     while (sqlite3_step(stmt) == SQLITE_ROW) {
-        RawSteamRow row;
-        row.url                      = get_text(stmt, 0);
-        row.types                    = get_text(stmt, 1);
-        row.name                     = get_text(stmt, 2);
-        row.desc_snippet             = get_text(stmt, 3);
-        row.recent_reviews           = get_text(stmt, 4);
-        row.all_reviews              = get_text(stmt, 5);
-        row.release_date             = get_text(stmt, 6);
-        row.developer                = get_text(stmt, 7);
-        row.publisher                = get_text(stmt, 8);
-        row.popular_tags             = get_text(stmt, 9);
-        row.game_details             = get_text(stmt, 10);
-        row.languages                = get_text(stmt, 11);
-        row.achievements             = get_text(stmt, 12);
-        row.genre                    = get_text(stmt, 13);
-        row.game_description         = get_text(stmt, 14);
-        row.mature_content           = get_text(stmt, 15);
-        row.minimum_requirements     = get_text(stmt, 16);
-        row.recommended_requirements = get_text(stmt, 17);
-        row.original_price           = get_text(stmt, 18);
-        row.discount_price           = get_text(stmt, 19);
-
-        rawRows.push_back(row);
+        rawRows.push_back(read_raw_row(stmt));
     }
 
     sqlite3_finalize(stmt);
@@ -106,17 +116,6 @@ bool load_raw_rows() {
     return true;
 }
 
-// Utility to escape quotes and wrap field in quotes for CSV
-string escape_csv(const string& input) {
-    string output = input;
-    size_t pos = 0;
-    while ((pos = output.find("\"", pos)) != string::npos) {
-        output.insert(pos, "\"");  // Double the quote
-        pos += 2;
-    }
-    return "\"" + output + "\"";
-}
-
 // Debugging export to verify raw data
 void export_raw_debug() {
     ofstream file("debug_raw_rows.csv");
@@ -150,76 +149,33 @@ void export_raw_debug() {
     file.close();
     cout << "📁 Raw row export saved to debug_raw_rows.csv\n";
 }
-// ===================== Part 3: Struct Definitions & Data Formatter =====================
-
-struct SteamGame {
-    std::string url;
-    std::string types;
-    std::string name;
-    std::string desc_snippet;
-    std::string recent_reviews;
-    std::string all_reviews;
-    std::string release_date;
-    std::string developer;
-    std::string publisher;
-    std::string popular_tags;
-    std::string game_details;
-    std::string languages;
-    std::string achievements;
-    std::string genre;
-    std::string game_description;
-    std::string mature_content;
-    std::string minimum_requirements;
-    std::string recommended_requirements;
-    std::string price_str;
-
-    float original_price = -1.0f;
-    float all_reviews_percent = -1.0f;
-    float recent_reviews_percent = -1.0f;
-    std::string overall_genre;
-};
-
-std::vector<SteamGame> structured_games;
-
-// Merge genre fields
-std::string merge_genres(const std::string& tags, const std::string& details, const std::string& genre) {
-    std::set<std::string> genre_set;
-    std::stringstream ss(tags + "," + details + "," + genre);
-    std::string token;
-    while (std::getline(ss, token, ',')) {
-        token.erase(std::remove_if(token.begin(), token.end(), ::isspace), token.end());
-        if (!token.empty()) genre_set.insert(token);
-    }
-
-    std::string result;
-    for (const auto& g : genre_set) {
-        if (!result.empty()) result += ", ";
-        result += g;
-    }
-    return result;
-}
-
-// Extract the last number before a '%' symbol
-float extract_review_percent(const std::string& text) {
-    size_t pos = text.rfind('%');
-    if (pos == std::string::npos) return -1.0f;
 
-    size_t start = pos;
-    while (start > 0 && (isdigit(text[start - 1]) || text[start - 1] == '.')) {
-        start--;
-    }
+// ===================== Part 3: Struct Definitions & Data Formatter =====================
 
-    std::string num = text.substr(start, pos - start);
-    try {
-        return std::stof(num);
-    } catch (...) {
-        return -1.0f;
+// Split each distinct pooled languages value once; games share the token list
+void build_language_tokens() {
+    language_tokens.assign(string_pool.size(), {});
+    std::vector<bool> done(string_pool.size(), false);
+    for (const auto& game : structured_games) {
+        uint32_t id = game.languages.id;
+        if (done[id]) continue;
+        done[id] = true;
+
+        std::stringstream ss(string_pool.get(id));
+        std::string lang;
+        while (std::getline(ss, lang, ',')) {
+            lang.erase(std::remove_if(lang.begin(), lang.end(), ::isspace), lang.end());
+            if (!lang.empty()) language_tokens[id].push_back(language_dict.insert(lang));
+        }
     }
 }
 
 // Convert RawSteamRow → SteamGame with validation
 void format_all_games() {
     structured_games.clear();
+    string_pool.clear();
+    genre_dict.clear();
+    language_dict.clear();
 
     for (const auto& row : rawRows) {
         try {
@@ -231,50 +187,36 @@ void format_all_games() {
             game.recent_reviews           = row.recent_reviews;
             game.all_reviews              = row.all_reviews;
             game.release_date             = row.release_date;
-            game.developer                = row.developer;
-            game.publisher                = row.publisher;
-            game.popular_tags             = row.popular_tags;
+            game.developer.id             = string_pool.intern(row.developer);
+            game.publisher.id             = string_pool.intern(row.publisher);
+            game.popular_tags.id          = string_pool.intern(row.popular_tags);
             game.game_details             = row.game_details;
-            game.languages                = row.languages;
+            game.languages.id             = string_pool.intern(row.languages);
             game.achievements             = row.achievements;
             game.genre                    = row.genre;
             game.game_description         = row.game_description;
             game.mature_content           = row.mature_content;
             game.minimum_requirements     = row.minimum_requirements;
             game.recommended_requirements = row.recommended_requirements;
-            game.price_str                = row.original_price;
 
             // Parse cleaned values
             game.all_reviews_percent = extract_review_percent(row.all_reviews);
             game.recent_reviews_percent = extract_review_percent(row.recent_reviews);
-            game.overall_genre = merge_genres(row.popular_tags, row.game_details, row.genre);
+            std::set<std::string> genres = genre_tokens(row.popular_tags, row.game_details, row.genre);
+            game.overall_genre = join_genres(genres);
 
             // Parse price
-            std::string price = row.original_price;
-            std::transform(price.begin(), price.end(), price.begin(), ::tolower);
-            if (price.empty()) continue;
-
-            if (price.find("free") != std::string::npos) {
-                game.original_price = 0.0f;
-            } else {
-                price.erase(std::remove_if(price.begin(), price.end(), [](char c) {
-                    return !(isdigit(c) || c == '.' || c == '-');
-                }), price.end());
-
-                if (price.empty()) continue;
-
-                try {
-                    game.original_price = std::stof(price);
-                } catch (...) {
-                    continue;
-                }
-            }
+            game.original_price = parse_price(row.original_price);
+            if (std::isnan(game.original_price)) continue;
 
+            for (const auto& genre : genres)
+                game.genre_ids.push_back(genre_dict.insert(genre));
             structured_games.push_back(game);
         } catch (...) {
             continue;
         }
     }
+    build_language_tokens();
 
     std::cout << "✅ Structured " << structured_games.size() << " games successfully.\n";
 }
@@ -292,13 +234,13 @@ void export_structured_debug(const std::string& filename = "formatted_debug.csv"
     for (const auto& game : structured_games) {
         file << escape_csv(game.name) << ","
              << escape_csv(game.release_date) << ","
-             << escape_csv(game.developer) << ","
-             << escape_csv(game.publisher) << ","
+             << escape_csv(game.developer.str()) << ","
+             << escape_csv(game.publisher.str()) << ","
              << game.original_price << ","
              << game.all_reviews_percent << ","
              << game.recent_reviews_percent << ","
              << escape_csv(game.overall_genre) << ","
-             << escape_csv(game.languages) << ","
+             << escape_csv(game.languages.str()) << ","
              << escape_csv(game.minimum_requirements) << ","
              << escape_csv(game.recommended_requirements) << "\n";
     }
@@ -306,92 +248,18 @@ void export_structured_debug(const std::string& filename = "formatted_debug.csv"
     file.close();
     std::cout << "📁 Structured export saved to " << filename << "\n";
 }
-// ===================== Part 4: System Requirements Analyzer =====================
-
-struct SystemSpec {
-    std::string os;
-    std::string cpu;
-    std::string gpu;
-    int ram_gb = 0;
-    int storage_gb = 0;
-};
-
-// Extract RAM in GB
-int extract_ram(const std::string& text) {
-    std::regex ram_pattern(R"((\d{1,3})\s*(GB|Mb|MB|gb|mb))");
-    std::smatch match;
-    if (std::regex_search(text, match, ram_pattern)) {
-        try {
-            int value = std::stoi(match[1].str());
-            std::string unit = match[2].str();
-            if (unit == "MB" || unit == "mb" || unit == "Mb") value /= 1024;
-            if (value > 0 && value <= 256) return value;  // Limit to 256 GB
-        } catch (...) {
-            return 0;
-        }
-    }
-    return 0;
-}
-
-// Extract Storage in GB
-int extract_storage(const std::string& text) {
-    std::regex storage_pattern(R"((\d{1,4})\s*(GB|Gb|MB|Mb))");
-    std::smatch match;
-    if (std::regex_search(text, match, storage_pattern)) {
-        try {
-            int value = std::stoi(match[1].str());
-            std::string unit = match[2].str();
-            if (unit == "MB" || unit == "mb") value /= 1024;
-            if (value > 0 && value <= 2000) return value;  // Limit to 2TB
-        } catch (...) {
-            return 0;
-        }
-    }
-    return 0;
-}
-
-// Generic helper: find line containing keyword
-std::string extract_line(const std::string& text, const std::string& key) {
-    std::istringstream iss(text);
-    std::string line;
-    while (std::getline(iss, line)) {
-        if (line.find(key) != std::string::npos) {
-            return line;
-        }
-    }
-    return "";
-}
-
-// Extract all specs from a single text blob
-SystemSpec parse_spec_block(const std::string& block) {
-    SystemSpec spec;
-    std::string line;
-
-    line = extract_line(block, "OS");
-    if (!line.empty()) spec.os = line;
-
-    line = extract_line(block, "Processor");
-    if (line.empty()) line = extract_line(block, "CPU");
-    if (!line.empty()) spec.cpu = line;
 
-    line = extract_line(block, "Graphics");
-    if (line.empty()) line = extract_line(block, "GPU");
-    if (!line.empty()) spec.gpu = line;
+// ===================== Part 3b: Compact Numeric Columns =====================
 
-    spec.ram_gb = extract_ram(block);
-    spec.storage_gb = extract_storage(block);
+// The column store itself is in steam_common.h; filled in one pass here
+void build_compact_columns() {
+    compact_columns.reset(structured_games.size());
+    fill_compact_columns(0, structured_games.size());
 
-    return spec;
+    std::cout << "🗜️  Compact columns built: " << compact_columns.bytes() << " bytes for " << structured_games.size() << " games\n";
 }
 
-// Compare and update with most demanding values
-void take_max(SystemSpec& base, const SystemSpec& current) {
-    if (base.ram_gb < current.ram_gb) base.ram_gb = current.ram_gb;
-    if (base.storage_gb < current.storage_gb) base.storage_gb = current.storage_gb;
-    if (base.os.empty() || current.os > base.os) base.os = current.os;
-    if (base.cpu.empty() || current.cpu > base.cpu) base.cpu = current.cpu;
-    if (base.gpu.empty() || current.gpu > base.gpu) base.gpu = current.gpu;
-}
+// ===================== Part 4: System Requirements Analyzer =====================
 
 // Final system specs
 SystemSpec min_required_system;
@@ -451,48 +319,62 @@ void export_requirements_debug(const std::string& filename = "system_requirement
     file.close();
     std::cout << "📄 System requirements summary saved to " << filename << "\n";
 }
+
 // ===================== Part 5: Top Games & Genres Analyzer =====================
 
-struct TopGame {
-    std::string name;
-    std::string developer;
-    float rating;
-    float price;
-    std::string release_date;
-};
+// Bounded heap over 'rows' (or all rows when null); rated, named games only
+template <class View>
+std::vector<RankedRow> select_top(const View& v, const std::vector<size_t>* rows, size_t n, const TopKQuery& q) {
+    auto eligible = [&](size_t r) { return v.has_all(r) && !structured_games[r].name.empty(); };
+
+    std::vector<RankedRow> heap;  // heap front is the worst row kept
+    heap.reserve(q.k);
+    for (size_t j = 0; j < n; ++j) {
+        size_t r = rows ? (*rows)[j] : j;
+        if (!eligible(r)) continue;
+
+        RankedRow cand{ static_cast<float>(v.all(r)), r };
+        if (heap.size() < q.k) {
+            heap.push_back(cand);
+            std::push_heap(heap.begin(), heap.end(), ranks_before);
+        } else if (ranks_before(cand, heap.front())) {
+            std::pop_heap(heap.begin(), heap.end(), ranks_before);
+            heap.back() = cand;
+            std::push_heap(heap.begin(), heap.end(), ranks_before);
+        }
+    }
+
+    // Rows tied with the worst kept row but ranked after it were dropped by the heap
+    if (q.ties == TiePolicy::KeepTies && heap.size() == q.k) {
+        RankedRow worst = heap.front();
+        for (size_t j = 0; j < n; ++j) {
+            size_t r = rows ? (*rows)[j] : j;
+            if (r > worst.row && eligible(r) && static_cast<float>(v.all(r)) == worst.rating)
+                heap.push_back({ worst.rating, r });
+        }
+    }
 
-// Global containers
-std::vector<TopGame> top_games;
-std::vector<std::pair<std::string, int>> top_genres;
+    std::sort(heap.begin(), heap.end(), ranks_before);
+    return heap;
+}
 
-// Generate all games tied at highest rating
-void compute_top_games() {
-    std::vector<TopGame> all;
-    for (const auto& game : structured_games) {
-        if (game.all_reviews_percent < 0 || game.name.empty()) continue;
+std::vector<RankedRow> select_top(const std::vector<size_t>* rows, size_t n, const TopKQuery& q) {
+    return use_compact_columns ? select_top(CompactColumnsView{compact_columns}, rows, n, q)
+                               : select_top(FloatColumnsView{structured_games}, rows, n, q);
+}
 
+// Generate all games tied at highest rating (or the configured top K)
+void compute_top_games() {
+    top_games.clear();
+    for (const auto& r : select_top(nullptr, structured_games.size(), top_games_query)) {
+        const SteamGame& game = structured_games[r.row];
         TopGame g;
         g.name = game.name;
-        g.developer = game.developer;
-        g.rating = game.all_reviews_percent;
+        g.developer = game.developer.str();
+        g.rating = r.rating;
         g.price = game.original_price;
         g.release_date = game.release_date;
-        all.push_back(g);
-    }
-
-    std::sort(all.begin(), all.end(), [](const TopGame& a, const TopGame& b) {
-        return a.rating > b.rating;
-    });
-
-    top_games.clear();
-    float max_rating = all.empty() ? -1.0f : all[0].rating;
-
-    for (const auto& g : all) {
-        if (g.rating == max_rating) {
-            top_games.push_back(g);
-        } else {
-            break;
-        }
+        top_games.push_back(g);
     }
 }
 
@@ -510,8 +392,9 @@ void compute_top_genres() {
     }
 
     std::vector<std::pair<std::string, int>> genre_list(genre_count.begin(), genre_count.end());
+    // Equal counts are ordered by name so the pick does not depend on hash order
     std::sort(genre_list.begin(), genre_list.end(), [](auto& a, auto& b) {
-        return b.second < a.second;
+        return a.second != b.second ? a.second > b.second : a.first < b.first;
     });
 
     top_genres.assign(genre_list.begin(), genre_list.begin() + std::min<size_t>(5, genre_list.size()));
@@ -558,100 +441,28 @@ void export_top_genres(const std::string& filename = "top_5_genres.csv") {
     file.close();
     std::cout << "📄 Top genres saved to " << filename << "\n";
 }
-// ===================== Part 6: Developer-Level Stats =====================
-
-struct DeveloperStats {
-    std::string developer;
-    float avg_rating = 0.0f;
-    float avg_price = 0.0f;
-    std::string most_common_genre;
-    std::string least_common_genre;
-    std::string most_common_language;
-    std::string least_common_language;
-};
-
-std::vector<DeveloperStats> developer_stats;
-
-void compute_developer_stats() {
-    std::unordered_map<std::string, std::vector<const SteamGame*>> dev_map;
-
-    // Group all games by developer
-    for (const auto& game : structured_games) {
-        if (!game.developer.empty()) {
-            dev_map[game.developer].push_back(&game);
-        }
-    }
-
-    for (const auto& [dev, games] : dev_map) {
-        if (games.empty()) continue;
-
-        float rating_sum = 0.0f;
-        int rating_count = 0;
-        float price_sum = 0.0f;
-        int price_count = 0;
-
-        std::unordered_map<std::string, int> genre_count;
-        std::unordered_map<std::string, int> lang_count;
-
-        for (const auto* game : games) {
-            // ✅ Use both recent and all_reviews for average rating
-            float combined_rating = -1.0f;
-            if (game->all_reviews_percent >= 0 && game->recent_reviews_percent >= 0)
-                combined_rating = (game->all_reviews_percent + game->recent_reviews_percent) / 2;
-            else if (game->all_reviews_percent >= 0)
-                combined_rating = game->all_reviews_percent;
-            else if (game->recent_reviews_percent >= 0)
-                combined_rating = game->recent_reviews_percent;
-
-            if (combined_rating >= 0) {
-                rating_sum += combined_rating;
-                rating_count++;
-            }
-
-            if (game->original_price >= 0) {
-                price_sum += game->original_price;
-                price_count++;
-            }
-
-            std::stringstream genre_ss(game->overall_genre);
-            std::string genre;
-            while (std::getline(genre_ss, genre, ',')) {
-                genre.erase(std::remove_if(genre.begin(), genre.end(), ::isspace), genre.end());
-                if (!genre.empty()) genre_count[genre]++;
-            }
 
-            std::stringstream lang_ss(game->languages);
-            std::string lang;
-            while (std::getline(lang_ss, lang, ',')) {
-                lang.erase(std::remove_if(lang.begin(), lang.end(), ::isspace), lang.end());
-                if (!lang.empty()) lang_count[lang]++;
-            }
-        }
+// ===================== Part 5b: Group-By Aggregation Engine =====================
+// The engine (key columns, aggregate functors, GroupByReport) is shared with the parallel
+// pipeline through steam_common.h; here a report runs in a single pass over every row.
 
-        DeveloperStats stat;
-        stat.developer = dev;
-        stat.avg_rating = rating_count ? rating_sum / rating_count : 0.0f;
-        stat.avg_price = price_count ? price_sum / price_count : 0.0f;
-
-        if (!genre_count.empty()) {
-            auto [max_it, min_it] = std::minmax_element(
-                genre_count.begin(), genre_count.end(),
-                [](auto& a, auto& b) { return a.second < b.second; });
-            stat.most_common_genre = max_it->first;
-            stat.least_common_genre = min_it->first;
-        }
+template <class Report, class View>
+auto run_report(const Report& report, const View& v) {
+    typename Report::Table table;
+    report.aggregate(v, 0, structured_games.size(), table);
+    return report.finish_all(table, v);
+}
 
-        if (!lang_count.empty()) {
-            auto [max_it, min_it] = std::minmax_element(
-                lang_count.begin(), lang_count.end(),
-                [](auto& a, auto& b) { return a.second < b.second; });
-            stat.most_common_language = max_it->first;
-            stat.least_common_language = min_it->first;
-        }
+template <class Report>
+auto run_report(const Report& report) {
+    return use_compact_columns ? run_report(report, CompactColumnsView{compact_columns})
+                               : run_report(report, FloatColumnsView{structured_games});
+}
 
-        developer_stats.push_back(stat);
-    }
+// ===================== Part 6: Developer-Level Stats =====================
 
+void compute_developer_stats() {
+    developer_stats = run_report(developer_report);
     std::cout << "📊 Computed developer-level stats for " << developer_stats.size() << " developers.\n";
 }
 
@@ -676,98 +487,11 @@ void export_developer_stats(const std::string& filename = "developer_stats.csv")
     file.close();
     std::cout << "📄 Developer stats exported to " << filename << "\n";
 }
-// ===================== Part 7: Publisher-Level Stats =====================
-
-struct PublisherStats {
-    std::string publisher;
-    float avg_rating = 0.0f;
-    float avg_price = 0.0f;
-    std::string most_common_genre;
-    std::string least_common_genre;
-    std::string most_common_language;
-    std::string least_common_language;
-};
 
-std::vector<PublisherStats> publisher_stats;
+// ===================== Part 7: Publisher-Level Stats =====================
 
 void compute_publisher_stats() {
-    std::unordered_map<std::string, std::vector<const SteamGame*>> pub_map;
-
-    for (const auto& game : structured_games) {
-        if (!game.publisher.empty()) {
-            pub_map[game.publisher].push_back(&game);
-        }
-    }
-
-    for (const auto& [pub, games] : pub_map) {
-        if (games.empty()) continue;
-
-        float rating_sum = 0.0f;
-        int rating_count = 0;
-        float price_sum = 0.0f;
-        int price_count = 0;
-
-        std::unordered_map<std::string, int> genre_count;
-        std::unordered_map<std::string, int> lang_count;
-
-        for (const auto* game : games) {
-            float combined_rating = -1.0f;
-            if (game->all_reviews_percent >= 0 && game->recent_reviews_percent >= 0)
-                combined_rating = (game->all_reviews_percent + game->recent_reviews_percent) / 2;
-            else if (game->all_reviews_percent >= 0)
-                combined_rating = game->all_reviews_percent;
-            else if (game->recent_reviews_percent >= 0)
-                combined_rating = game->recent_reviews_percent;
-
-            if (combined_rating >= 0) {
-                rating_sum += combined_rating;
-                rating_count++;
-            }
-
-            if (game->original_price >= 0) {
-                price_sum += game->original_price;
-                price_count++;
-            }
-
-            std::stringstream genre_ss(game->overall_genre);
-            std::string genre;
-            while (std::getline(genre_ss, genre, ',')) {
-                genre.erase(std::remove_if(genre.begin(), genre.end(), ::isspace), genre.end());
-                if (!genre.empty()) genre_count[genre]++;
-            }
-
-            std::stringstream lang_ss(game->languages);
-            std::string lang;
-            while (std::getline(lang_ss, lang, ',')) {
-                lang.erase(std::remove_if(lang.begin(), lang.end(), ::isspace), lang.end());
-                if (!lang.empty()) lang_count[lang]++;
-            }
-        }
-
-        PublisherStats stat;
-        stat.publisher = pub;
-        stat.avg_rating = rating_count ? rating_sum / rating_count : 0.0f;
-        stat.avg_price = price_count ? price_sum / price_count : 0.0f;
-
-        if (!genre_count.empty()) {
-            auto [max_it, min_it] = std::minmax_element(
-                genre_count.begin(), genre_count.end(),
-                [](auto& a, auto& b) { return a.second < b.second; });
-            stat.most_common_genre = max_it->first;
-            stat.least_common_genre = min_it->first;
-        }
-
-        if (!lang_count.empty()) {
-            auto [max_it, min_it] = std::minmax_element(
-                lang_count.begin(), lang_count.end(),
-                [](auto& a, auto& b) { return a.second < b.second; });
-            stat.most_common_language = max_it->first;
-            stat.least_common_language = min_it->first;
-        }
-
-        publisher_stats.push_back(stat);
-    }
-
+    publisher_stats = run_report(publisher_report);
     std::cout << "📊 Computed publisher-level stats for " << publisher_stats.size() << " publishers.\n";
 }
 
@@ -792,28 +516,22 @@ void export_publisher_stats(const std::string& filename = "publisher_stats.csv")
     file.close();
     std::cout << "📄 Publisher stats exported to " << filename << "\n";
 }
+
 // ===================== Part 8: Benchmarking =====================
 
-#include <chrono>
-#include <functional>
 using namespace std::chrono;
 
-struct BenchmarkEntry {
-    std::string part;
-    long long duration_ms;
-};
-
-std::vector<BenchmarkEntry> benchmark_log;
-
 // ✅ Clean timing wrapper function
 void benchmark(const std::string& label, const std::function<void()>& func) {
-    auto start = high_resolution_clock::now();
+    auto start = steady_clock::now();
+    PerfCounts before = perf_read();
     func();
-    auto end = high_resolution_clock::now();
+    PerfCounts counters = perf_read() - before;
+    auto end = steady_clock::now();
 
-    auto duration = duration_cast<milliseconds>(end - start).count();
-    benchmark_log.push_back({label, duration});
-    std::cout << "⏱️  " << label << ": " << duration << " ms\n";
+    long long duration = duration_cast<nanoseconds>(end - start).count();
+    benchmark_log.push_back({label, duration, counters});
+    std::cout << "⏱️  " << label << ": " << duration / 1e6 << " ms\n";
 }
 
 // ✅ Export formatted benchmark report
@@ -827,12 +545,12 @@ void export_benchmark_summary(const std::string& filename = "benchmark_results.c
     // ⏱ Section 1: Timing
     file << "Timing Summary\n";
     file << "Part,Time (ms)\n";
-    long long total_time = 0;
+    double total_time = 0;
 
     for (const auto& entry : benchmark_log) {
-        file << entry.part << "," << entry.duration_ms << "\n";
+        file << entry.part << "," << entry.duration_ns / 1e6 << "\n";
         if (entry.part != "Wall Clock Time")
-            total_time += entry.duration_ms;
+            total_time += entry.duration_ns / 1e6;
     }
 
     file << "Total Execution Time," << total_time << "\n";
@@ -845,7 +563,7 @@ void export_benchmark_summary(const std::string& filename = "benchmark_results.c
     file << "Total Games Processed," << structured_games.size() << "\n";
 
     if (total_time > 0) {
-        double throughput = static_cast<double>(structured_games.size()) / (static_cast<double>(total_time) / 1000.0);
+        double throughput = static_cast<double>(structured_games.size()) / (total_time / 1000.0);
         file << "Throughput (games/sec)," << throughput << "\n";
     }
 
@@ -857,8 +575,8 @@ void export_benchmark_summary(const std::string& filename = "benchmark_results.c
 
     std::set<std::string> unique_devs, unique_pubs, unique_genres;
     for (const auto& g : structured_games) {
-        if (!g.developer.empty()) unique_devs.insert(g.developer);
-        if (!g.publisher.empty()) unique_pubs.insert(g.publisher);
+        if (!g.developer.empty()) unique_devs.insert(g.developer.str());
+        if (!g.publisher.empty()) unique_pubs.insert(g.publisher.str());
 
         std::stringstream ss(g.overall_genre);
         std::string genre;
@@ -871,6 +589,59 @@ void export_benchmark_summary(const std::string& filename = "benchmark_results.c
     file << "Unique Developers," << unique_devs.size() << "\n";
     file << "Unique Publishers," << unique_pubs.size() << "\n";
     file << "Unique Genres," << unique_genres.size() << "\n";
+    file << "\n";
+
+    // 🧵 Section 4: String Pool (developer, publisher, languages, popular_tags)
+    file << "String Pool Stats\n";
+    file << "Metric,Value\n";
+    file << "Pooled Values," << string_pool.requests << "\n";
+    file << "Unique Values," << string_pool.size() << "\n";
+    file << "Logical Bytes," << string_pool.requested_bytes << "\n";
+    file << "Stored Bytes," << string_pool.stored_bytes << "\n";
+    file << "Bytes Saved," << string_pool.requested_bytes - string_pool.stored_bytes << "\n";
+    if (string_pool.stored_bytes > 0) {
+        double ratio = static_cast<double>(string_pool.requested_bytes) / static_cast<double>(string_pool.stored_bytes);
+        file << "Dedup Ratio," << ratio << "\n";
+    }
+
+    // 🗜️ Section 5: Compact numeric columns (only with --compact)
+    if (use_compact_columns) {
+        file << "\n";
+        file << "Compact Columns\n";
+        file << "Metric,Value\n";
+        file << "Float Column Bytes," << structured_games.size() * 3 * sizeof(float) << "\n";
+        file << "Compact Column Bytes," << compact_columns.bytes() << "\n";
+    }
+
+    // 🔬 Section 6: Hardware counters per stage (only with --perf-counters)
+    if (perf_counters_enabled) {
+        file << "\n";
+        file << "Hardware Counters\n";
+        bool any = std::any_of(benchmark_log.begin(), benchmark_log.end(),
+                               [](const BenchmarkEntry& e) { return e.counters.valid; });
+        if (!any) {
+            file << "Status,unavailable (timing only)\n";
+        } else {
+            size_t rows = rawRows.size();
+            file << "Part,Cycles,Instructions,IPC,Cache Misses,Branch Misses,Page Faults,"
+                 << "Cache Misses/Row,Branch Misses/Row\n";
+            auto count = [&](const PerfCounts& c, int e) { return c.has(e) ? std::to_string(c.value[e]) : std::string(); };
+            auto per_row = [&](const PerfCounts& c, int e) {
+                return c.has(e) && rows > 0 ? std::to_string((double)c.value[e] / rows) : std::string();
+            };
+            for (const auto& entry : benchmark_log) {
+                const PerfCounts& c = entry.counters;
+                if (!c.valid) continue;
+                std::string ipc = c.has(PERF_CYCLES) && c.has(PERF_INSTRUCTIONS) && c.value[PERF_CYCLES] > 0
+                                      ? std::to_string((double)c.value[PERF_INSTRUCTIONS] / c.value[PERF_CYCLES])
+                                      : std::string();
+                file << entry.part << "," << count(c, PERF_CYCLES) << "," << count(c, PERF_INSTRUCTIONS) << ","
+                     << ipc << "," << count(c, PERF_CACHE_MISSES) << "," << count(c, PERF_BRANCH_MISSES) << ","
+                     << count(c, PERF_PAGE_FAULTS) << "," << per_row(c, PERF_CACHE_MISSES) << ","
+                     << per_row(c, PERF_BRANCH_MISSES) << "\n";
+            }
+        }
+    }
 
     file.close();
     std::cout << "📊 Benchmark results saved to " << filename << "\n";
@@ -950,85 +721,177 @@ void export_benchmark_summary(const std::string& filename = "benchmark_results.c
     return 0;
 }*/
 
-int main() {
-    lock_to_one_cpu();  // Force single-core
+// Command-line flags
+std::string db_path = "steam.db";   // --db PATH, e.g. a generate_steam_data.py database
+std::vector<int> size_limits = {1000, 2000, 5000, 10000, 20000, 30000, 40000};   // --limits
+bool export_results = false;        // --export: write every result CSV for the last run
 
-    std::vector<int> limits = {1000, 2000, 5000, 10000, 20000, 30000, 40000};
-    std::ofstream log_file("size_vs_time_log.csv");
-    log_file << "Version,Input Size,Execution Time (ms),Wall Clock Time (ms)\n";
+void print_usage() {
+    std::cerr << "Usage: Sequential [--compact] [--top-k K] [--top-ties keep|exact] [--cpus LIST]\n"
+              << "                  [--warmup N] [--reps N] [--db PATH] [--limits N[,N...]]\n"
+              << "                  [--perf-counters] [--export]\n";
+}
 
-    for (int limit : limits) {
-        benchmark_log.clear();
-        std::cout << "\n📊 Running benchmark with LIMIT = " << limit << " rows...\n";
+// A flag value that does not parse is a usage error, not an exception
+bool bad_value(const std::string& flag, const std::string& value) {
+    std::cerr << "❌ Bad value for " << flag << ": " << value << "\n";
+    print_usage();
+    return false;
+}
 
-        int rc = sqlite3_open("steam.db", &db);
-        if (rc != SQLITE_OK) {
-            std::cerr << "❌ Failed to open database.\n";
-            return 1;
+bool parse_args(int argc, char* argv[]) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--compact") {
+            use_compact_columns = true;
+        } else if (arg == "--top-k" && i + 1 < argc) {
+            if (!parse_count(argv[++i], top_games_query.k) || top_games_query.k == 0) return bad_value(arg, argv[i]);
+        } else if (arg == "--top-ties" && i + 1 < argc) {
+            std::string policy = argv[++i];
+            if (policy == "keep") top_games_query.ties = TiePolicy::KeepTies;
+            else if (policy == "exact") top_games_query.ties = TiePolicy::Exact;
+            else return bad_value(arg, policy);
+        } else if (arg == "--db" && i + 1 < argc) {
+            db_path = argv[++i];
+        } else if (arg == "--limits" && i + 1 < argc) {
+            size_limits = parse_size_list(argv[++i]);
+            if (size_limits.empty()) {
+                std::cerr << "❌ Bad size list: " << argv[i] << "\n";
+                return false;
+            }
+        } else if (arg == "--perf-counters") {
+            perf_counters_enabled = true;
+        } else if (arg == "--export") {
+            export_results = true;
+        } else if (arg == "--warmup" && i + 1 < argc) {
+            if (!parse_count(argv[++i], warmup_runs)) return bad_value(arg, argv[i]);
+        } else if (arg == "--reps" && i + 1 < argc) {
+            if (!parse_count(argv[++i], measured_runs) || measured_runs == 0) return bad_value(arg, argv[i]);
+        } else if (arg == "--cpus" && i + 1 < argc) {
+            cpu_list = parse_int_list(argv[++i]);
+            if (cpu_list.empty()) {
+                std::cerr << "❌ Bad CPU list: " << argv[i] << "\n";
+                return false;
+            }
+        } else {
+            std::cerr << "❌ Unknown option: " << arg << "\n";
+            print_usage();
+            return false;
         }
+    }
+    return true;
+}
 
-        auto wall_start = std::chrono::high_resolution_clock::now();
+// -- One full pipeline run at 'limit' rows; fills benchmark_log, returns false if the DB won't open
+bool run_pipeline(int limit, long long& exec_ns, long long& wall_ns) {
+    benchmark_log.clear();
+    int rc = sqlite3_open(db_path.c_str(), &db);
+    if (rc != SQLITE_OK) {
+        std::cerr << "❌ Failed to open database.\n";
+        return false;
+    }
 
-        // Load rows with limit
-        benchmark("load_raw_rows", [limit]() {
-            std::string query = "SELECT * FROM steam_games LIMIT " + std::to_string(limit) + ";";
-            sqlite3_stmt* stmt;
+    auto wall_start = std::chrono::steady_clock::now();
 
-            if (sqlite3_prepare_v2(db, query.c_str(), -1, &stmt, nullptr) != SQLITE_OK) {
-                std::cerr << "❌ Failed to prepare SELECT: " << sqlite3_errmsg(db) << std::endl;
-                return;
-            }
+    // Load rows with limit
+    benchmark("load_raw_rows", [limit]() {
+        std::string query = "SELECT * FROM steam_games LIMIT " + std::to_string(limit) + ";";
+        sqlite3_stmt* stmt;
 
-            rawRows.clear();
-            while (sqlite3_step(stmt) == SQLITE_ROW) {
-                RawSteamRow row;
-                row.url = get_text(stmt, 0);
-                row.types = get_text(stmt, 1);
-                row.name = get_text(stmt, 2);
-                row.desc_snippet = get_text(stmt, 3);
-                row.recent_reviews = get_text(stmt, 4);
-                row.all_reviews = get_text(stmt, 5);
-                row.release_date = get_text(stmt, 6);
-                row.developer = get_text(stmt, 7);
-                row.publisher = get_text(stmt, 8);
-                row.popular_tags = get_text(stmt, 9);
-                row.game_details = get_text(stmt, 10);
-                row.languages = get_text(stmt, 11);
-                row.achievements = get_text(stmt, 12);
-                row.genre = get_text(stmt, 13);
-                row.game_description = get_text(stmt, 14);
-                row.mature_content = get_text(stmt, 15);
-                row.minimum_requirements = get_text(stmt, 16);
-                row.recommended_requirements = get_text(stmt, 17);
-                row.original_price = get_text(stmt, 18);
-                row.discount_price = get_text(stmt, 19);
-                rawRows.push_back(row);
-                if (rawRows.size() >= limit) break;
-            }
+        if (sqlite3_prepare_v2(db, query.c_str(), -1, &stmt, nullptr) != SQLITE_OK) {
+            std::cerr << "❌ Failed to prepare SELECT: " << sqlite3_errmsg(db) << std::endl;
+            return;
+        }
 
-            sqlite3_finalize(stmt);
-        });
+        rawRows.clear();
+        while (sqlite3_step(stmt) == SQLITE_ROW) {
+            RawSteamRow row;
+            row.url = get_text(stmt, 0);
+            row.types = get_text(stmt, 1);
+            row.name = get_text(stmt, 2);
+            row.desc_snippet = get_text(stmt, 3);
+            row.recent_reviews = get_text(stmt, 4);
+            row.all_reviews = get_text(stmt, 5);
+            row.release_date = get_text(stmt, 6);
+            row.developer = get_text(stmt, 7);
+            row.publisher = get_text(stmt, 8);
+            row.popular_tags = get_text(stmt, 9);
+            row.game_details = get_text(stmt, 10);
+            row.languages = get_text(stmt, 11);
+            row.achievements = get_text(stmt, 12);
+            row.genre = get_text(stmt, 13);
+            row.game_description = get_text(stmt, 14);
+            row.mature_content = get_text(stmt, 15);
+            row.minimum_requirements = get_text(stmt, 16);
+            row.recommended_requirements = get_text(stmt, 17);
+            row.original_price = get_text(stmt, 18);
+            row.discount_price = get_text(stmt, 19);
+            rawRows.push_back(row);
+            if (rawRows.size() >= limit) break;
+        }
 
-        benchmark("format_all_games", [] { format_all_games(); });
-        benchmark("analyze_system_requirements", [] { analyze_system_requirements(); });
-        benchmark("compute_top_games", [] { compute_top_games(); });
-        benchmark("compute_top_genres", [] { compute_top_genres(); });
-        benchmark("compute_developer_stats", [] { compute_developer_stats(); });
-        benchmark("compute_publisher_stats", [] { compute_publisher_stats(); });
+        sqlite3_finalize(stmt);
+    });
 
-        auto wall_end = std::chrono::high_resolution_clock::now();
-        long long exec_time = 0;
-        for (const auto& entry : benchmark_log)
-            exec_time += entry.duration_ms;
+    benchmark("format_all_games", [] { format_all_games(); });
+    if (use_compact_columns)
+        benchmark("build_compact_columns", [] { build_compact_columns(); });
+    benchmark("analyze_system_requirements", [] { analyze_system_requirements(); });
+    benchmark("compute_top_games", [] { compute_top_games(); });
+    benchmark("compute_top_genres", [] { compute_top_genres(); });
+    benchmark("compute_developer_stats", [] { compute_developer_stats(); });
+    benchmark("compute_publisher_stats", [] { compute_publisher_stats(); });
+
+    auto wall_end = std::chrono::steady_clock::now();
+    exec_ns = 0;
+    for (const auto& entry : benchmark_log)
+        exec_ns += entry.duration_ns;
+    wall_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(wall_end - wall_start).count();
 
-        long long wall_time = std::chrono::duration_cast<std::chrono::milliseconds>(wall_end - wall_start).count();
-        log_file << "Sequential," << limit << "," << exec_time << "," << wall_time << "\n";
+    sqlite3_close(db);
+    return true;
+}
 
-        sqlite3_close(db);
+// Every result CSV of the last run, as the old single-run main wrote them (--export);
+// differential_check.py compares these against the parallel program's
+void export_all_results() {
+    export_raw_debug();
+    export_structured_debug();
+    export_requirements_debug();
+    export_top_games();
+    export_top_genres();
+    export_developer_stats();
+    export_publisher_stats();
+}
+
+int main(int argc, char* argv[]) {
+    if (!parse_args(argc, argv)) return 1;
+    lock_to_one_cpu();  // Force single-core
+
+    std::ofstream log_file("size_vs_time_log.csv");
+    log_file << "Version,Input Size,Execution Time (ms),Wall Clock Time (ms)\n";
+
+    for (int limit : size_limits) {
+        std::cout << "\n📊 Running benchmark with LIMIT = " << limit << " rows ("
+                  << warmup_runs << " warmup + " << measured_runs << " measured runs)...\n";
+
+        for (int run = 0; run < warmup_runs + measured_runs; ++run) {
+            long long exec_ns = 0, wall_ns = 0;
+            if (!run_pipeline(limit, exec_ns, wall_ns)) return 1;
+            if (run >= warmup_runs) record_run(limit, 1, exec_ns, wall_ns);
+        }
+
+        // Medians over the measured runs
+        log_file << "Sequential," << limit << "," << median_ms({"Execution Time", limit, 1}) << ","
+                 << median_ms({"Wall Clock Time", limit, 1}) << "\n";
     }
 
     log_file.close();
     std::cout << "📄 Logged results to size_vs_time_log.csv\n";
+    export_benchmark_stats("sequential");
+    if (export_results) export_all_results();
+
+    // Summary reflects the last (largest) run
+    export_benchmark_summary();
     return 0;
 }
-
@@ -0,0 +1,341 @@
+import argparse
+import csv
+import math
+import os
+import random
+import sqlite3
+import time
+
+# Deterministic synthetic steam_games generator for scale tests beyond the 40k-row CSV.
+# The same --seed always produces the same rows, whichever output format is chosen:
+#   python generate_steam_data.py --rows 1000000 --seed 42 --out steam_1m.db
+#   python generate_steam_data.py --rows 200000 --format csv --out steam_200k.csv
+# Sweep it with e.g. "parallel --db steam_1m.db --limits 100k,500k,1M".
+# Field formats follow steam_games.csv (review strings, "$" prices, flattened requirement
+# blocks, comma-joined tag lists), with skewed developer/publisher popularity.
+
+# === Settings ===
+parser = argparse.ArgumentParser(description="Generate a synthetic steam_games dataset.")
+parser.add_argument("--rows", type=int, default=100000, help="number of rows to generate")
+parser.add_argument("--seed", type=int, default=42, help="random seed")
+parser.add_argument("--format", choices=["sqlite", "csv"], default="sqlite")
+parser.add_argument("--out", default=None, help="output file (default steam_synthetic.db / .csv)")
+parser.add_argument("--batch", type=int, default=10000, help="rows per insert batch")
+args = parser.parse_args()
+
+table_name = "steam_games"
+out_file = args.out or ("steam_synthetic.db" if args.format == "sqlite" else "steam_synthetic.csv")
+
+# Same columns and order as steam_games.csv; pandas stores achievements as REAL
+columns = [
+    "url", "types", "name", "desc_snippet", "recent_reviews", "all_reviews", "release_date",
+    "developer", "publisher", "popular_tags", "game_details", "languages", "achievements",
+    "genre", "game_description", "mature_content", "minimum_requirements",
+    "recommended_requirements", "original_price", "discount_price",
+]
+
+# === Step 1: Vocabularies (weights are the rough share of games carrying each value) ===
+GENRES = [
+    ("Indie", 0.55), ("Action", 0.40), ("Adventure", 0.35), ("Casual", 0.30),
+    ("Simulation", 0.20), ("Strategy", 0.20), ("RPG", 0.18), ("Early Access", 0.10),
+    ("Free to Play", 0.07), ("Sports", 0.05), ("Racing", 0.04), ("Massively Multiplayer", 0.03),
+    ("Violent", 0.02), ("Gore", 0.015), ("Nudity", 0.01), ("Sexual Content", 0.01),
+    ("Design & Illustration", 0.01), ("Utilities", 0.01), ("Animation & Modeling", 0.006),
+    ("Education", 0.005), ("Video Production", 0.004), ("Audio Production", 0.004),
+    ("Software Training", 0.003), ("Web Publishing", 0.002), ("Photo Editing", 0.002),
+]
+
+TAGS = [
+    ("Indie", 30), ("Action", 25), ("Adventure", 20), ("Casual", 18), ("Singleplayer", 16),
+    ("Simulation", 12), ("Strategy", 12), ("RPG", 11), ("Atmospheric", 9), ("2D", 9),
+    ("Puzzle", 8), ("Great Soundtrack", 8), ("Multiplayer", 7), ("Early Access", 6),
+    ("Story Rich", 6), ("Pixel Graphics", 6), ("Free to Play", 5), ("Open World", 5),
+    ("Fantasy", 5), ("Horror", 5), ("Platformer", 5), ("Sci-fi", 5), ("First-Person", 5),
+    ("Shooter", 5), ("Co-op", 4), ("Difficult", 4), ("Funny", 4), ("Anime", 4),
+    ("Retro", 4), ("Sports", 3), ("Racing", 3), ("Survival", 3), ("Exploration", 3),
+    ("FPS", 3), ("Third Person", 3), ("Female Protagonist", 3), ("VR", 3), ("Arcade", 3),
+    ("Turn-Based", 2), ("Point & Click", 2), ("Sandbox", 2), ("Visual Novel", 2),
+    ("Management", 2), ("Tactical", 2), ("Building", 2), ("Rogue-like", 2), ("Cute", 2),
+    ("Violent", 2), ("Gore", 2), ("Massively Multiplayer", 1), ("Psychological Horror", 1),
+    ("Space", 1), ("Zombies", 1), ("Comedy", 1), ("Hack and Slash", 1), ("Stealth", 1),
+    ("Local Co-Op", 1), ("Classic", 1), ("Nudity", 1), ("Choices Matter", 1),
+]
+
+DETAILS = [
+    ("Single-player", 0.90), ("Steam Achievements", 0.60), ("Steam Trading Cards", 0.30),
+    ("Steam Cloud", 0.30), ("Full controller support", 0.20), ("Partial Controller Support", 0.12),
+    ("Multi-player", 0.15), ("Online Multi-Player", 0.10), ("Local Multi-Player", 0.06),
+    ("Co-op", 0.08), ("Online Co-op", 0.06), ("Shared/Split Screen", 0.05),
+    ("Steam Leaderboards", 0.12), ("Stats", 0.06), ("Steam Workshop", 0.04),
+    ("In-App Purchases", 0.03), ("Includes level editor", 0.03), ("Captions available", 0.02),
+    ("Commentary available", 0.01), ("Valve Anti-Cheat enabled", 0.005),
+]
+
+LANGUAGES = [
+    ("French", 0.35), ("German", 0.35), ("Spanish - Spain", 0.30), ("Russian", 0.30),
+    ("Simplified Chinese", 0.30), ("Italian", 0.25), ("Japanese", 0.20),
+    ("Portuguese - Brazil", 0.20), ("Korean", 0.15), ("Polish", 0.15),
+    ("Traditional Chinese", 0.15), ("Turkish", 0.10), ("Spanish - Latin America", 0.08),
+    ("Czech", 0.06), ("Dutch", 0.06), ("Swedish", 0.05), ("Hungarian", 0.04),
+    ("Ukrainian", 0.04), ("Thai", 0.03), ("Arabic", 0.02),
+]
+
+NAME_WORDS = [
+    "Dark", "Lost", "Star", "Dragon", "Shadow", "Iron", "Crystal", "Wild", "Last", "Hidden",
+    "Space", "Dungeon", "Kingdom", "Legend", "Tower", "Island", "Empire", "Hero", "Knight",
+    "Quest", "City", "Night", "Zombie", "Pixel", "Rogue", "Tales", "Escape", "Planet",
+    "Battle", "Dream", "Forest", "Ocean", "Machine", "Ghost", "Blade", "Storm", "Galaxy",
+]
+NAME_TAILS = ["", "", "", "", " 2", " II", " III", ": Remastered", " - Soundtrack", " VR",
+              ": Definitive Edition", " Deluxe Edition", "™", " - Season Pass", ": Origins"]
+
+STUDIO_WORDS = [
+    "Red", "Blue", "Pixel", "Iron", "Moon", "Star", "Fox", "Owl", "Bit", "Nova", "Stone",
+    "Frost", "Lunar", "Crow", "Tiny", "Big", "Happy", "Ember", "Cyber", "Echo",
+]
+STUDIO_SUFFIXES = ["Games", "Studios", "Interactive", "Entertainment", "Software",
+                   "Studio", "Games LLC", "Co., Ltd.", "Inc.", "Digital"]
+
+FREE_PRICES = ["Free", "Free to Play", "Free To Play", "Free Demo", "Free Mod", "Play for Free!"]
+PRICE_POINTS = [0.99, 1.99, 2.99, 3.99, 4.99, 6.99, 7.99, 9.99, 12.99, 14.99, 19.99,
+                24.99, 29.99, 34.99, 39.99, 49.99, 59.99]
+MONTHS = ["Jan", "Feb", "Mar", "Apr", "May", "Jun", "Jul", "Aug", "Sep", "Oct", "Nov", "Dec"]
+
+OSES = ["Windows XP", "Windows 7", "Windows 7 64-bit", "Windows 7 SP1+", "Windows 8.1",
+        "Windows 10", "Windows 10 64-bit", "Windows Vista/7/8/10"]
+CPUS = ["Intel Core 2 Duo 2.4GHz", "Intel Core i3", "Intel Core i5-2400", "Intel Core i5-4460",
+        "Intel Core i7-4770", "AMD FX-6300", "AMD Ryzen 5 1600", "1.8 GHz Dual Core",
+        "Intel Pentium 4 2.0 GHz", "Intel Core i3 or equivalent"]
+GPUS = ["NVIDIA GeForce 8800 GT", "NVIDIA GeForce GTX 660", "NVIDIA GeForce GTX 970",
+        "NVIDIA GeForce GTX 1060 6GB", "AMD Radeon HD 7870", "AMD Radeon RX 580",
+        "Intel HD Graphics 4000", "DirectX 9 compatible card with 256 MB",
+        "OpenGL 2.0 compatible", "Integrated graphics"]
+RAM_VALUES = ["512 MB RAM", "1 GB RAM", "2 GB RAM", "2GB RAM", "4 GB RAM", "4 GB",
+              "6 GB RAM", "8 GB RAM", "8GB RAM", "12 GB RAM", "16 GB RAM"]
+STORAGE_VALUES = ["200 MB available space", "500 MB available space", "1 GB available space",
+                  "2 GB available space", "4 GB available space", "10 GB available space",
+                  "20 GB available space", "35 GB available space", "60 GB available space"]
+DIRECTX = ["Version 9.0c", "Version 10", "Version 11", "Version 12"]
+
+LOREM = ("explore build fight survive discover craft trade upgrade unlock defend a vast "
+         "procedurally generated world full of secrets enemies allies and treasure in this "
+         "hand crafted adventure with a branching story and dozens of hours of content").split()
+
+# === Step 2: Row generator ===
+rng = random.Random(args.seed)
+
+developer_pool = max(50, int(args.rows * 0.45))
+publisher_pool = max(20, int(args.rows * 0.15))
+
+
+def studio_name(prefix, index):
+    # Distinct, stable name per index; some real studio names contain commas
+    a = STUDIO_WORDS[index % len(STUDIO_WORDS)]
+    b = STUDIO_WORDS[(index // len(STUDIO_WORDS)) % len(STUDIO_WORDS)]
+    suffix = STUDIO_SUFFIXES[(index * 7) % len(STUDIO_SUFFIXES)]
+    return f"{a}{b} {suffix}" if index < 400 else f"{prefix} {a}{b} {index} {suffix}"
+
+
+def skewed_index(pool, skew):
+    # P(index < r) = (r / pool) ** (1 / skew): a few huge studios and a long tail
+    return min(pool - 1, int(pool * rng.random() ** skew))
+
+
+TAG_NAMES = [t for t, _ in TAGS]
+TAG_CUM_WEIGHTS = [sum(w for _, w in TAGS[:i + 1]) for i in range(len(TAGS))]
+
+
+def pick_tags(genres, count):
+    # Store tags usually lead with the game's genres, then popular tags by weight
+    picks = [g for g in genres if g in TAG_NAMES][:count]
+    while len(picks) < count:
+        tag = rng.choices(TAG_NAMES, cum_weights=TAG_CUM_WEIGHTS)[0]
+        if tag not in picks:
+            picks.append(tag)
+    return picks
+
+
+def independent_subset(vocab):
+    return [v for v, p in vocab if rng.random() < p]
+
+
+def review_label(pct, n):
+    if n < 10:
+        return None
+    if pct >= 95 and n >= 500:
+        return "Overwhelmingly Positive"
+    if pct >= 80:
+        return "Very Positive" if n >= 50 else "Positive"
+    if pct >= 70:
+        return "Mostly Positive"
+    if pct >= 40:
+        return "Mixed"
+    if pct >= 20:
+        return "Mostly Negative"
+    if n >= 500:
+        return "Overwhelmingly Negative"
+    return "Very Negative" if n >= 50 else "Negative"
+
+
+def review_string(n, window):
+    pct = min(100, max(0, int(rng.gauss(76, 16))))
+    label = review_label(pct, n)
+    if label is None:
+        return f"{n} user reviews,- Need more user reviews to generate a score"
+    count = f"{n:,}"
+    return f"{label},({count}),- {pct}% of the {count} user reviews {window} are positive."
+
+
+def requirement_block(kind, level):
+    os_name = OSES[min(len(OSES) - 1, max(0, level + rng.randint(-2, 1)))]
+    fields = [
+        ("OS", os_name),
+        ("Processor", CPUS[min(len(CPUS) - 1, level + rng.randint(0, 3))]),
+        ("Memory", RAM_VALUES[min(len(RAM_VALUES) - 1, level + rng.randint(0, 4))]),
+        ("Graphics", GPUS[min(len(GPUS) - 1, level + rng.randint(0, 3))]),
+        ("DirectX", rng.choice(DIRECTX)),
+    ]
+    storage = rng.choice(STORAGE_VALUES)
+    style = rng.random()
+    if style < 0.80:
+        # Steam's flattened form: "Minimum:,OS:,Windows 7,Processor:,..."
+        parts = [f"{kind}:"]
+        if level >= 3 and rng.random() < 0.5:
+            parts.append("Requires a 64-bit processor and operating system")
+        for key, value in fields:
+            parts += [f"{key}:", value]
+        parts += ["Storage:", storage]
+        if rng.random() < 0.2:
+            parts += ["Additional Notes:", "Internet connection required for activation"]
+        return ",".join(parts)
+    if style < 0.92:
+        # Older store pages: "Key: value" on one line each, "Hard Drive:" instead of "Storage:"
+        lines = [f"{kind}:"] + [f"{key}: {value}" for key, value in fields]
+        lines.append(f"Hard Drive: {storage.replace('available space', 'HD space')}")
+        return "\n".join(lines)
+    # Free-form text some publishers paste in
+    return f"{kind}: {os_name}, {fields[1][1]}, {fields[2][1]}, {fields[3][1]}"
+
+
+def nullable(value):
+    return value if value else None
+
+
+def make_row(i):
+    kind = rng.random()
+    app_type = "app" if kind < 0.95 else ("bundle" if kind < 0.98 else "sub")
+    app_id = 10 + i * 10 + rng.randint(0, 9)
+
+    # Name: a couple of title words, a tail, and now and then a quote or comma
+    name = " ".join(rng.sample(NAME_WORDS, rng.randint(1, 3))) + rng.choice(NAME_TAILS)
+    odd = rng.random()
+    if odd < 0.02:
+        name = f'"{name}"'
+    elif odd < 0.04:
+        name = name.replace(" ", ", ", 1)
+    elif odd < 0.05:
+        name = ""
+    slug = "".join(c if c.isalnum() else "_" for c in name)[:40]
+    url = f"https://store.steampowered.com/{app_type}/{app_id}/{slug}/"
+
+    year = min(2019, 1997 + int(22 * rng.random() ** 0.35))
+    release_date = f"{rng.choice(MONTHS)} {rng.randint(1, 28)}, {year}" if rng.random() < 0.97 else ""
+
+    developer = studio_name("Dev", skewed_index(developer_pool, 1.8))
+    if rng.random() < 0.06:
+        developer += "," + studio_name("Dev", skewed_index(developer_pool, 1.8))
+    if rng.random() < 0.55:
+        publisher = developer
+    else:
+        publisher = studio_name("Publishing", skewed_index(publisher_pool, 2.2))
+    if rng.random() < 0.03:
+        developer, publisher = "", ""
+
+    # Review strings: lognormal review counts, about a third of games have none
+    all_reviews = ""
+    if rng.random() < 0.70:
+        all_reviews = review_string(max(1, int(rng.lognormvariate(3.5, 1.8))), "for this game")
+    recent_reviews = ""
+    if all_reviews and rng.random() < 0.15:
+        recent_reviews = review_string(max(1, int(rng.lognormvariate(2.5, 1.4))), "in the last 30 days")
+
+    genres = independent_subset(GENRES) or [rng.choice(GENRES)[0]]
+    popular_tags = pick_tags(genres, min(20, int(rng.triangular(1, 21, 20))))
+    details = independent_subset(DETAILS) or ["Single-player"]
+    languages = ["English"] if rng.random() < 0.97 else [rng.choice(LANGUAGES)[0]]
+    if rng.random() < 0.55:
+        languages += [l for l in independent_subset(LANGUAGES) if l not in languages]
+
+    achievements = float(int(rng.lognormvariate(3.0, 1.0))) if rng.random() < 0.55 else None
+    mature = None
+    if rng.random() < 0.04:
+        mature = "Mature Content Description  The developers describe the content like this:  " \
+                 "This game contains violence and blood."
+
+    words = rng.randint(8, 20)
+    desc_snippet = " ".join(rng.choice(LOREM) for _ in range(words)).capitalize() + "."
+    description = "About This Game " + " ".join(rng.choice(LOREM) for _ in range(words * 6))
+
+    # Prices: typical price points, several "free" spellings, some empty
+    p = rng.random()
+    if p < 0.08:
+        original_price = ""
+    elif p < 0.16:
+        original_price = rng.choice(FREE_PRICES)
+    elif p < 0.17:
+        original_price = f"${rng.randint(100, 1999):,}.99"
+    else:
+        original_price = f"${rng.choice(PRICE_POINTS):.2f}"
+    discount_price = ""
+    if original_price.startswith("$") and rng.random() < 0.3:
+        value = float(original_price[1:].replace(",", ""))
+        discount_price = f"${math.floor(value * rng.choice([0.5, 0.6, 0.75, 0.8, 0.9])) + 0.99:.2f}"
+
+    level = rng.randint(0, 5)
+    minimum = requirement_block("Minimum", level) if rng.random() < 0.92 else ""
+    recommended = requirement_block("Recommended", level + 2) if minimum and rng.random() < 0.55 else ""
+
+    return (
+        url, app_type, nullable(name), nullable(desc_snippet), nullable(recent_reviews),
+        nullable(all_reviews), nullable(release_date), nullable(developer), nullable(publisher),
+        ",".join(popular_tags), ",".join(details), ",".join(languages), achievements,
+        ",".join(genres), description, mature, nullable(minimum), nullable(recommended),
+        nullable(original_price), nullable(discount_price),
+    )
+
+
+# === Step 3: Write rows in batches ===
+start = time.time()
+if os.path.exists(out_file):
+    os.remove(out_file)
+
+try:
+    if args.format == "sqlite":
+        conn = sqlite3.connect(out_file)
+        conn.execute("PRAGMA journal_mode = OFF")
+        conn.execute("PRAGMA synchronous = OFF")
+        column_defs = ", ".join(f'"{c}" {"REAL" if c == "achievements" else "TEXT"}' for c in columns)
+        conn.execute(f'CREATE TABLE "{table_name}" ({column_defs})')
+        insert = f'INSERT INTO "{table_name}" VALUES ({", ".join("?" * len(columns))})'
+        written = 0
+        while written < args.rows:
+            batch = [make_row(i) for i in range(written, min(args.rows, written + args.batch))]
+            conn.executemany(insert, batch)
+            written += len(batch)
+            if written % 1000000 < args.batch:
+                print(f"⚙️ {written:,} rows ({time.time() - start:.0f}s)")
+        conn.commit()
+        conn.close()
+    else:
+        with open(out_file, "w", newline="", encoding="utf-8") as f:
+            writer = csv.writer(f)
+            writer.writerow(columns)
+            for i in range(args.rows):
+                row = make_row(i)
+                writer.writerow(["" if v is None else v for v in row])
+                if (i + 1) % 1000000 == 0:
+                    print(f"⚙️ {i + 1:,} rows ({time.time() - start:.0f}s)")
+    print(f"✅ Generated {args.rows:,} rows (seed {args.seed}) into '{out_file}' in {time.time() - start:.1f}s")
+except Exception as e:
+    print(f"❌ Failed to generate dataset: {e}")
+    exit(1)